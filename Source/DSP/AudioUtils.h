@@ -1,7 +1,16 @@
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 
+/**
+ * Build with CLEMMY3_EXACT_TANH=1 to replace the tanh approximations
+ * (fastTanh and SIMDOps::tanh) with std::tanh for reference renders
+ */
+#ifndef CLEMMY3_EXACT_TANH
+    #define CLEMMY3_EXACT_TANH 0
+#endif
+
 namespace AudioUtils
 {
     /**
@@ -53,6 +62,44 @@ namespace AudioUtils
         return 0.0f;
     }
 
+    /**
+     * Fast tanh for drive and filter saturation
+     *
+     * [7/6] Pade approximant of tanh, input clamped to +-4.97 where the
+     * approximant reaches 1. Max error 1e-4 at the clamp point, below 1e-6
+     * for |x| < 3. Branch-free, so loops over it auto-vectorize; the lane
+     * version is SIMDOps::tanh.
+     */
+    inline float fastTanh(float x)
+    {
+       #if CLEMMY3_EXACT_TANH
+        return std::tanh(x);
+       #else
+        x = std::min(std::max(x, -4.97f), 4.97f);
+        const float x2 = x * x;
+
+        const float num = (((x2 + 378.0f) * x2 + 17325.0f) * x2 + 135135.0f) * x;
+        const float den = ((28.0f * x2 + 3150.0f) * x2 + 62370.0f) * x2 + 135135.0f;
+
+        return std::min(std::max(num / den, -1.0f), 1.0f);
+       #endif
+    }
+
+    /**
+     * Fast tan for filter cutoff prewarping, x in [0, 1.42] (up to 0.45 * sample rate)
+     *
+     * [5/4] Pade approximant, relative error below 3e-5 (0.05 cents of cutoff).
+     * The lane version is SIMDOps::tan.
+     */
+    inline float fastTan(float x)
+    {
+        const float x2 = x * x;
+        const float num = ((x2 - 105.0f) * x2 + 945.0f) * x;
+        const float den = (15.0f * x2 - 420.0f) * x2 + 945.0f;
+
+        return num / den;
+    }
+
     /**
      * Wrap phase to 0.0-1.0 range
      * @param phase Phase value to wrap (modified in-place)
@@ -135,3 +135,80 @@ float Envelope::processSample()
     // Apply velocity to final output
     return currentLevel * velocity;
 }
+
+int Envelope::processBlock(float* output, int numSamples)
+{
+    int i = 0;
+
+    while (i < numSamples)
+    {
+        switch (currentPhase)
+        {
+            case Phase::Idle:
+                // Nothing left to render - report where the envelope finished
+                std::fill(output + i, output + numSamples, 0.0f);
+                return i;
+
+            case Phase::Sustain:
+                // Level is constant until note-off
+                std::fill(output + i, output + numSamples, sustainLevel * velocity);
+                return numSamples;
+
+            case Phase::Attack:
+                // Ramp up until the peak is reached or the block ends
+                while (i < numSamples)
+                {
+                    currentLevel += attackRate;
+
+                    if (currentLevel >= 1.0f)
+                    {
+                        currentLevel = 1.0f;
+                        output[i++] = currentLevel * velocity;
+                        enterPhase(Phase::Decay);
+                        break;
+                    }
+
+                    output[i++] = currentLevel * velocity;
+                }
+                break;
+
+            case Phase::Decay:
+                // Ramp down until the sustain level is reached or the block ends
+                while (i < numSamples)
+                {
+                    currentLevel -= decayRate;
+
+                    if (currentLevel <= sustainLevel)
+                    {
+                        currentLevel = sustainLevel;
+                        output[i++] = currentLevel * velocity;
+                        enterPhase(Phase::Sustain);
+                        break;
+                    }
+
+                    output[i++] = currentLevel * velocity;
+                }
+                break;
+
+            case Phase::Release:
+                // Ramp down until silent or the block ends
+                while (i < numSamples)
+                {
+                    currentLevel -= releaseRate;
+
+                    if (currentLevel <= 0.0f)
+                    {
+                        currentLevel = 0.0f;
+                        output[i++] = 0.0f;
+                        enterPhase(Phase::Idle);
+                        break;
+                    }
+
+                    output[i++] = currentLevel * velocity;
+                }
+                break;
+        }
+    }
+
+    return numSamples;
+}
@@ -61,6 +61,16 @@ public:
      */
     float processSample();
 
+    /**
+     * Process a block of samples
+     * Sustain and idle stretches are filled without per-sample state checks
+     * @param output Destination buffer for envelope levels (overwritten)
+     * @param numSamples Number of samples to generate
+     * @return Number of samples rendered before the envelope went idle
+     *         (numSamples if it is still active at the end of the block)
+     */
+    int processBlock(float* output, int numSamples);
+
     /**
      * Check if envelope is active (not idle)
      */
@@ -71,7 +81,14 @@ public:
      */
     Phase getCurrentPhase() const { return currentPhase; }
 
+    /**
+     * Get current envelope level (before velocity scaling)
+     */
+    float getCurrentLevel() const { return currentLevel; }
+
 private:
+    friend class VoiceLanes;  // Loads/stores level and phase for voice-parallel rendering
+
     // Current state
     Phase currentPhase = Phase::Idle;
     float currentLevel = 0.0f;
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * FastRandom - Small seeded pseudo-random generator for the audio thread
+ *
+ * LANES independent xorshift32 streams are stepped together. fillBipolar()'s
+ * inner loop is plain 32-bit shifts and xors, so compilers turn it into SIMD
+ * code (4 or 8 values per instruction). Single values come from the same
+ * streams through a LANES-sized buffer, so per-sample and block use produce
+ * the same sequence.
+ *
+ * Each owner (noise generator, voice) has its own instance: no global state,
+ * no locks, and the output depends only on the seed.
+ */
+class FastRandom
+{
+public:
+    static constexpr int LANES = 8;
+
+    explicit FastRandom(uint32_t seed = 1)
+    {
+        setSeed(seed);
+    }
+
+    /**
+     * Restart the sequence
+     * Nearby seeds (e.g. consecutive voice indices) give unrelated sequences
+     */
+    void setSeed(uint32_t seed)
+    {
+        // splitmix32 spreads the seed over the lanes (xorshift states must be non-zero)
+        for (auto& laneState : state)
+        {
+            seed += 0x9E3779B9u;
+            uint32_t z = seed;
+            z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+            z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+            z ^= z >> 16;
+            laneState = z != 0 ? z : 0x6D2B79F5u;
+        }
+
+        position = LANES;
+    }
+
+    /**
+     * Uniform value in [-1, 1]
+     */
+    float nextBipolar()
+    {
+        if (position == LANES)
+        {
+            step(buffer.data());
+            position = 0;
+        }
+
+        return buffer[static_cast<size_t>(position++)];
+    }
+
+    /**
+     * Uniform value in [0, 1)
+     */
+    float nextFloat()
+    {
+        const float value = nextBipolar() * 0.5f + 0.5f;
+        return value < 1.0f ? value : 0.0f;
+    }
+
+    /**
+     * Fill a buffer with uniform values in [-1, 1] (white noise)
+     */
+    void fillBipolar(float* output, int numSamples)
+    {
+        int i = 0;
+
+        // Use up values already buffered by nextBipolar() to stay on one sequence
+        while (position < LANES && i < numSamples)
+            output[i++] = buffer[static_cast<size_t>(position++)];
+
+        for (; i + LANES <= numSamples; i += LANES)
+            step(output + i);
+
+        while (i < numSamples)
+            output[i++] = nextBipolar();
+    }
+
+private:
+    std::array<uint32_t, LANES> state {};
+    std::array<float, LANES> buffer {};  // Values not yet handed out by nextBipolar()
+    int position = LANES;                // Next buffered value (LANES = empty)
+
+    /**
+     * Advance every lane once and write LANES values
+     */
+    void step(float* output)
+    {
+        // Local copies keep the loop free of aliasing between state and output
+        std::array<uint32_t, LANES> x = state;
+        std::array<float, LANES> values;
+
+        for (size_t lane = 0; lane < LANES; ++lane)
+        {
+            x[lane] ^= x[lane] << 13;
+            x[lane] ^= x[lane] >> 17;
+            x[lane] ^= x[lane] << 5;
+
+            // Reinterpret as signed and scale by 2^-31
+            values[lane] = static_cast<float>(static_cast<int32_t>(x[lane])) * (1.0f / 2147483648.0f);
+        }
+
+        state = x;
+
+        for (size_t lane = 0; lane < LANES; ++lane)
+            output[lane] = values[lane];
+    }
+};
@@ -2,8 +2,7 @@
 #include <algorithm>
 
 LFO::LFO()
-    : randomGenerator(std::random_device{}())
-    , randomDistribution(-1.0f, 1.0f)
+    : tables(LookupTables::acquire())
 {
     updatePhaseIncrement();
 }
@@ -18,7 +17,12 @@ void LFO::reset()
 {
     phase = 0.0f;
     lastPhase = 0.0f;
-    sampleAndHoldValue = randomDistribution(randomGenerator);
+    sampleAndHoldValue = random.nextBipolar();
+}
+
+void LFO::setSeed(uint32_t seed)
+{
+    random.setSeed(seed);
 }
 
 void LFO::setWaveform(Waveform wf)
@@ -55,6 +59,19 @@ void LFO::setBPM(float newBPM)
     updatePhaseIncrement();
 }
 
+void LFO::setTransportPosition(double ppqPosition)
+{
+    if (rateMode != Sync)
+        return;
+
+    // Computed in double so the phase stays exact far into a song
+    const double cycles = ppqPosition / getBeatsPerCycle();
+    phase = static_cast<float>(cycles - std::floor(cycles));
+
+    if (phase >= 1.0f)
+        phase = 0.0f;
+}
+
 float LFO::processSample()
 {
     float value = 0.0f;
@@ -78,13 +95,59 @@ float LFO::processSample()
             break;
     }
 
-    // Advance phase
+    advancePhase();
+
+    return value * depth;
+}
+
+void LFO::processBlock(float* output, int numSamples)
+{
+    switch (waveform)
+    {
+        case Sine:
+            for (int i = 0; i < numSamples; ++i)
+            {
+                output[i] = generateSine() * depth;
+                advancePhase();
+            }
+            break;
+        case Triangle:
+            for (int i = 0; i < numSamples; ++i)
+            {
+                output[i] = generateTriangle() * depth;
+                advancePhase();
+            }
+            break;
+        case Square:
+            for (int i = 0; i < numSamples; ++i)
+            {
+                output[i] = generateSquare() * depth;
+                advancePhase();
+            }
+            break;
+        case Sawtooth:
+            for (int i = 0; i < numSamples; ++i)
+            {
+                output[i] = generateSawtooth() * depth;
+                advancePhase();
+            }
+            break;
+        case SampleAndHold:
+            for (int i = 0; i < numSamples; ++i)
+            {
+                output[i] = generateSampleAndHold() * depth;
+                advancePhase();
+            }
+            break;
+    }
+}
+
+void LFO::advancePhase()
+{
     lastPhase = phase;
     phase += phaseIncrement;
     if (phase >= 1.0f)
         phase -= 1.0f;
-
-    return value * depth;
 }
 
 float LFO::getCurrentValue() const
@@ -95,7 +158,7 @@ float LFO::getCurrentValue() const
     switch (waveform)
     {
         case Sine:
-            value = std::sin(phase * 2.0f * static_cast<float>(M_PI));
+            value = tables->sine(phase);
             break;
         case Triangle:
             if (phase < 0.5f)
@@ -119,7 +182,7 @@ float LFO::getCurrentValue() const
 
 float LFO::generateSine()
 {
-    return std::sin(phase * 2.0f * static_cast<float>(M_PI));
+    return tables->sine(phase);
 }
 
 float LFO::generateTriangle()
@@ -148,7 +211,7 @@ float LFO::generateSampleAndHold()
     // Generate new random value when phase wraps
     if (phase < lastPhase)  // Phase wrapped
     {
-        sampleAndHoldValue = randomDistribution(randomGenerator);
+        sampleAndHoldValue = random.nextBipolar();
     }
     return sampleAndHoldValue;
 }
@@ -161,29 +224,31 @@ float LFO::getEffectiveRate() const
     }
     else  // Sync mode
     {
-        // MIDI sync - convert division to Hz based on BPM
-        // beats_per_cycle = how many beats for one complete LFO cycle
-        float beatsPerCycle = 1.0f;
-
-        switch (syncDivision)
-        {
-            case Div_1_128: beatsPerCycle = 0.03125f; break;  // 1/128 note = 1/32 of a quarter beat (very fast)
-            case Div_1_64:  beatsPerCycle = 0.0625f;  break;  // 1/64 note = 1/16 of a quarter beat
-            case Div_1_32:  beatsPerCycle = 0.125f;   break;  // 1/32 note = 1/8 of a quarter beat
-            case Div_1_16:  beatsPerCycle = 0.25f;    break;  // 1/16 note = 1/4 of a quarter beat
-            case Div_1_8:   beatsPerCycle = 0.5f;     break;  // 1/8 note = 1/2 of a quarter beat
-            case Div_1_4:   beatsPerCycle = 1.0f;     break;  // 1/4 note = 1 beat
-            case Div_1_2:   beatsPerCycle = 2.0f;     break;  // 1/2 note = 2 beats
-            case Div_1_1:   beatsPerCycle = 4.0f;     break;  // Whole note = 4 beats
-            case Div_2_1:   beatsPerCycle = 8.0f;     break;  // 2 bars = 8 beats
-            case Div_4_1:   beatsPerCycle = 16.0f;    break;  // 4 bars = 16 beats (slow)
-        }
-
         // Convert BPM to Hz: (beats per minute / 60) / beats per cycle
-        return (bpm / 60.0f) / beatsPerCycle;
+        return (bpm / 60.0f) / getBeatsPerCycle();
     }
 }
 
+float LFO::getBeatsPerCycle() const
+{
+    // MIDI sync - how many beats for one complete LFO cycle
+    switch (syncDivision)
+    {
+        case Div_1_128: return 0.03125f;  // 1/128 note = 1/32 of a quarter beat (very fast)
+        case Div_1_64:  return 0.0625f;   // 1/64 note = 1/16 of a quarter beat
+        case Div_1_32:  return 0.125f;    // 1/32 note = 1/8 of a quarter beat
+        case Div_1_16:  return 0.25f;     // 1/16 note = 1/4 of a quarter beat
+        case Div_1_8:   return 0.5f;      // 1/8 note = 1/2 of a quarter beat
+        case Div_1_4:   return 1.0f;      // 1/4 note = 1 beat
+        case Div_1_2:   return 2.0f;      // 1/2 note = 2 beats
+        case Div_1_1:   return 4.0f;      // Whole note = 4 beats
+        case Div_2_1:   return 8.0f;      // 2 bars = 8 beats
+        case Div_4_1:   return 16.0f;     // 4 bars = 16 beats (slow)
+    }
+
+    return 1.0f;
+}
+
 void LFO::updatePhaseIncrement()
 {
     // Phase increment per sample = frequency / sample rate
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "FastRandom.h"
+#include "LookupTables.h"
 #include <cmath>
-#include <random>
+#include <cstdint>
 
 /**
  * LFO (Low Frequency Oscillator)
@@ -45,6 +47,11 @@ public:
     void setSampleRate(double sr);
     void reset();  // Reset phase to 0
 
+    /**
+     * Restart the sample & hold sequence (same seed = same random steps)
+     */
+    void setSeed(uint32_t seed);
+
     void setWaveform(Waveform wf);
     void setRate(float rateHz);  // 0.01 - 20 Hz (used in Free mode)
     void setDepth(float depth);  // 0.0 - 1.0
@@ -52,13 +59,24 @@ public:
     void setSyncDivision(SyncDivision division);
     void setBPM(float bpm);  // For MIDI sync mode
 
+    /**
+     * Sync mode: lock the phase to the host transport (no effect in Free mode)
+     * @param ppqPosition Position in quarter notes; phase = position / beats per cycle, wrapped
+     */
+    void setTransportPosition(double ppqPosition);
+
     // Process one sample and return modulation value (-1 to +1, scaled by depth)
     float processSample();
 
+    // Process a block of samples (waveform dispatch once per block)
+    void processBlock(float* output, int numSamples);
+
     // Get current LFO value without advancing (for display)
     float getCurrentValue() const;
 
 private:
+    friend class VoiceLanes;  // Loads/stores phase state for voice-parallel rendering
+
     float generateSine();
     float generateTriangle();
     float generateSquare();
@@ -66,7 +84,9 @@ private:
     float generateSampleAndHold();
 
     void updatePhaseIncrement();
+    void advancePhase();
     float getEffectiveRate() const;  // Calculate rate based on mode
+    float getBeatsPerCycle() const;  // Sync mode cycle length in quarter notes
 
     double sampleRate = 44100.0;
     Waveform waveform = Sine;
@@ -76,12 +96,13 @@ private:
     float bpm = 120.0f;  // BPM (Sync mode)
     float depth = 0.0f;  // 0.0 - 1.0
 
+    std::shared_ptr<const LookupTables> tables;  // Shared sine table
+
     float phase = 0.0f;  // 0.0 - 1.0
     float phaseIncrement = 0.0f;
 
     // For sample & hold
     float sampleAndHoldValue = 0.0f;
     float lastPhase = 0.0f;
-    std::mt19937 randomGenerator;
-    std::uniform_real_distribution<float> randomDistribution;
+    FastRandom random;
 };
@@ -0,0 +1,35 @@
+#include "LookupTables.h"
+#include <mutex>
+
+#ifndef M_PI
+    #define M_PI 3.14159265358979323846
+#endif
+
+std::shared_ptr<const LookupTables> LookupTables::acquire()
+{
+    static std::mutex mutex;
+    static std::weak_ptr<const LookupTables> shared;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (auto existing = shared.lock())
+        return existing;
+
+    // First holder (or all previous holders are gone): build a fresh set
+    std::shared_ptr<const LookupTables> created(new LookupTables());
+    shared = created;
+    return created;
+}
+
+LookupTables::LookupTables()
+{
+    // Built in double precision, stored as float
+    for (size_t note = 0; note < noteTable.size(); ++note)
+        noteTable[note] = static_cast<float>(440.0 * std::pow(2.0, (static_cast<double>(note) - 69.0) / 12.0));
+
+    for (size_t cent = 0; cent < centsTable.size(); ++cent)
+        centsTable[cent] = static_cast<float>(std::pow(2.0, static_cast<double>(cent) / CENTS_PER_OCTAVE));
+
+    for (size_t n = 0; n < sineTable.size(); ++n)
+        sineTable[n] = static_cast<float>(std::sin(2.0 * M_PI * static_cast<double>(n) / SINE_TABLE_SIZE));
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Wavetable.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+
+/**
+ * LookupTables - Shared, read-only tables for the transcendental math in the voices
+ *
+ * Replaces per-sample libm calls with interpolated table reads:
+ * - noteToFrequency: MIDI note (0-127) to Hz
+ * - centsToRatio: pitch offset in cents to frequency ratio (any range)
+ * - sine: one cycle, phase in [0, 1)
+ *
+ * The band-limited oscillator wavetables live here as well.
+ *
+ * One instance is shared by every voice of every plugin instance in the
+ * process. acquire() builds it when the first holder asks for it and it is
+ * freed when the last holder releases it. Components acquire it in their
+ * constructors (never on the audio thread) and only read it afterwards.
+ */
+class LookupTables
+{
+public:
+    static constexpr int SINE_TABLE_SIZE = 4096;   // Samples per cycle (power of two)
+    static constexpr int CENTS_PER_OCTAVE = 1200;  // One table entry per cent
+
+    /**
+     * Shared tables (built on first use, freed with the last reference)
+     */
+    static std::shared_ptr<const LookupTables> acquire();
+
+    /**
+     * MIDI note to frequency (A4 = note 69 = 440 Hz)
+     * @param midiNote MIDI note number (clamped to 0-127)
+     */
+    float noteToFrequency(int midiNote) const
+    {
+        return noteTable[static_cast<size_t>(midiNote < 0 ? 0 : (midiNote > 127 ? 127 : midiNote))];
+    }
+
+    /**
+     * Frequency ratio for a pitch offset, 2^(cents / 1200)
+     * Whole octaves are exact powers of two; the rest is interpolated (error < 1e-7)
+     */
+    float centsToRatio(float cents) const
+    {
+        const float octaves = std::floor(cents * (1.0f / CENTS_PER_OCTAVE));
+        const float position = cents - octaves * CENTS_PER_OCTAVE;  // [0, 1200]
+        const int index = std::min(static_cast<int>(position), CENTS_PER_OCTAVE - 1);
+        const float fraction = position - static_cast<float>(index);
+        const auto i = static_cast<size_t>(index);
+
+        const float ratio = centsTable[i] + fraction * (centsTable[i + 1] - centsTable[i]);
+        return std::ldexp(ratio, static_cast<int>(octaves));
+    }
+
+    /**
+     * sin(2 * pi * phase) with linear interpolation (error < 3e-7)
+     * @param phase Phase in [0, 1)
+     */
+    float sine(double phase) const
+    {
+        const double position = phase * SINE_TABLE_SIZE;
+        const int index = static_cast<int>(position) & (SINE_TABLE_SIZE - 1);
+        const float fraction = static_cast<float>(position - std::floor(position));
+        const auto i = static_cast<size_t>(index);
+
+        return sineTable[i] + fraction * (sineTable[i + 1] - sineTable[i]);
+    }
+
+    const Wavetable& getWavetable() const { return wavetable; }
+
+private:
+    LookupTables();
+
+    std::array<float, 128> noteTable {};
+    std::array<float, CENTS_PER_OCTAVE + 1> centsTable {};   // Last entry = 2.0 (guard)
+    std::array<float, SINE_TABLE_SIZE + 1> sineTable {};     // Guard sample for interpolation
+
+    Wavetable wavetable;
+};
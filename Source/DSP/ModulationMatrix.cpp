@@ -0,0 +1,37 @@
+#include "ModulationMatrix.h"
+#include <algorithm>
+#include <cmath>
+
+void ModulationMatrix::setSlot(int index, Source source, Destination destination, float amount)
+{
+    if (index < 0 || index >= NUM_SLOTS)
+        return;
+
+    // Decided once here, so the rebuild below never compares floats
+    const bool active = source != SourceNone && destination != DestNone && std::fpclassify(amount) != FP_ZERO;
+    slots[static_cast<size_t>(index)] = { source, destination, amount, active };
+
+    // Rebuild the compact list the voices iterate over
+    numActiveSlots = 0;
+    targeted.fill(false);
+
+    for (const auto& slot : slots)
+    {
+        if (!slot.active)
+            continue;
+
+        activeSlots[static_cast<size_t>(numActiveSlots++)] = slot;
+        targeted[static_cast<size_t>(slot.destination)] = true;
+    }
+}
+
+void ModulationMatrix::evaluate(const float* sources, float* destinations) const
+{
+    std::fill(destinations, destinations + NumDestinations, 0.0f);
+
+    for (int i = 0; i < numActiveSlots; ++i)
+    {
+        const Slot& slot = activeSlots[static_cast<size_t>(i)];
+        destinations[slot.destination] += sources[slot.source] * slot.amount;
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+/**
+ * ModulationMatrix - Routes modulation sources to voice parameters
+ *
+ * Each slot connects one source to one destination with a bipolar amount.
+ * Slots 0 and 1 are the LFO 1/LFO 2 destination selectors (amount 1, the LFO
+ * depth already scales them); the other NUM_USER_SLOTS are free routings.
+ * Slots that target the same destination add up.
+ *
+ * Voices evaluate the matrix at control rate and interpolate in between, so
+ * destinations read smoothed per-sample modulation buffers. One unit of
+ * modulation means:
+ * - Filter cutoff: ±2x the base cutoff (linear, ~±2 octaves at full LFO depth)
+ * - Pitch: ±1 semitone (all oscillators)
+ * - PWM: ±25% pulse width around 50%
+ * - Filter resonance: ±0.5
+ * - Volume: ±25% around 75% (tremolo)
+ */
+class ModulationMatrix
+{
+public:
+    enum Source
+    {
+        SourceNone = 0,
+        SourceLFO1,
+        SourceLFO2,
+        SourceEnvelope,   // Amplitude envelope level (0 to 1, includes velocity)
+        SourceVelocity,   // Note-on velocity (0 to 1)
+        SourceNote,       // Key tracking: (note - 60) / 60, bipolar
+        SourceModWheel,   // MIDI CC 1 (0 to 1)
+        NumSources
+    };
+
+    // Same order as the LFO destination parameters
+    enum Destination
+    {
+        DestNone = 0,
+        DestFilterCutoff,
+        DestPitch,
+        DestPWM,
+        DestFilterRes,
+        DestVolume,
+        NumDestinations
+    };
+
+    static constexpr int LFO1_SLOT = 0;
+    static constexpr int LFO2_SLOT = 1;
+    static constexpr int NUM_USER_SLOTS = 4;
+    static constexpr int NUM_SLOTS = 2 + NUM_USER_SLOTS;
+
+    struct Slot
+    {
+        Source source = SourceNone;
+        Destination destination = DestNone;
+        float amount = 0.0f;
+        bool active = false;  // Source, destination and a non-zero amount are all set
+    };
+
+    /**
+     * Route a slot
+     * @param index LFO1_SLOT, LFO2_SLOT or 2 + user slot
+     */
+    void setSlot(int index, Source source, Destination destination, float amount);
+    const Slot& getSlot(int index) const { return slots[static_cast<size_t>(index)]; }
+
+    /**
+     * True if any slot with a non-zero amount routes a source to this destination
+     */
+    bool targets(Destination destination) const { return targeted[static_cast<size_t>(destination)]; }
+    bool targetsAny(Destination first, Destination second) const { return targets(first) || targets(second); }
+
+    /**
+     * True if any slot modulates anything
+     */
+    bool isActive() const { return numActiveSlots > 0; }
+
+    /**
+     * Slots that modulate something (source, destination and amount all set)
+     */
+    const Slot* getActiveSlots() const { return activeSlots.data(); }
+    int getNumActiveSlots() const { return numActiveSlots; }
+
+    /**
+     * Sum the slot contributions for each destination
+     * @param sources One value per Source
+     * @param destinations Receives one value per Destination (0 when untargeted)
+     */
+    void evaluate(const float* sources, float* destinations) const;
+
+private:
+    std::array<Slot, NUM_SLOTS> slots {};
+
+    // Derived from slots in setSlot
+    std::array<Slot, NUM_SLOTS> activeSlots {};
+    int numActiveSlots = 0;
+    std::array<bool, NumDestinations> targeted {};
+};
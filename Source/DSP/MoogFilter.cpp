@@ -1,4 +1,5 @@
 #include "MoogFilter.h"
+#include "AudioUtils.h"
 #include <algorithm>
 #include <cmath>
 
@@ -27,12 +28,21 @@ void MoogFilter::setMode(Mode m)
     mode = m;
 }
 
+void MoogFilter::setModel(Model m)
+{
+    // Both models keep their state in stage1-4, so switching doesn't need a reset
+    model = m;
+    coefficientsNeedUpdate = true;
+    rampSamplesRemaining = 0;
+}
+
 void MoogFilter::setCutoff(float cutoffHz)
 {
     // Clamp to valid range: 20 Hz - 12 kHz
     // Max 12 kHz is typical for analog Moog-style filters
     cutoff = std::clamp(cutoffHz, 20.0f, 12000.0f);
     coefficientsNeedUpdate = true;
+    rampSamplesRemaining = 0;
 }
 
 void MoogFilter::setResonance(float res)
@@ -40,6 +50,35 @@ void MoogFilter::setResonance(float res)
     // Clamp to 0.0 - 1.0 range
     resonance = std::clamp(res, 0.0f, 1.0f);
     coefficientsNeedUpdate = true;
+    rampSamplesRemaining = 0;
+}
+
+void MoogFilter::rampTo(float cutoffHz, float res, int numSamples)
+{
+    // Start from the coefficients for the current parameters
+    if (coefficientsNeedUpdate)
+    {
+        updateCoefficients();
+    }
+
+    cutoff = std::clamp(cutoffHz, 20.0f, 12000.0f);
+    resonance = std::clamp(res, 0.0f, 1.0f);
+    rampTarget = computeCoefficients();
+
+    if (numSamples <= 1)
+    {
+        g = rampTarget.g;
+        feedbackGain = rampTarget.feedbackGain;
+        outputGain = rampTarget.outputGain;
+        rampSamplesRemaining = 0;
+        return;
+    }
+
+    const float scale = 1.0f / static_cast<float>(numSamples);
+    rampStep.g = (rampTarget.g - g) * scale;
+    rampStep.feedbackGain = (rampTarget.feedbackGain - feedbackGain) * scale;
+    rampStep.outputGain = (rampTarget.outputGain - outputGain) * scale;
+    rampSamplesRemaining = numSamples;
 }
 
 float MoogFilter::processSample(float input)
@@ -50,20 +89,90 @@ float MoogFilter::processSample(float input)
         updateCoefficients();
     }
 
-    // Check for NaN/infinity in filter state and reset if detected
-    if (std::isnan(stage1) || std::isnan(stage2) || std::isnan(stage3) || std::isnan(stage4) ||
-        std::isinf(stage1) || std::isinf(stage2) || std::isinf(stage3) || std::isinf(stage4))
+    if (rampSamplesRemaining > 0)
+    {
+        stepRamp();
+    }
+
+    return filterSample(input);
+}
+
+void MoogFilter::processBlock(float* buffer, int numSamples)
+{
+    // Parameters can't change inside a block, so check once up front
+    if (coefficientsNeedUpdate)
+    {
+        updateCoefficients();
+    }
+
+    // Glide through what is left of a ramp, then run on fixed coefficients
+    const int rampLength = std::min(numSamples, rampSamplesRemaining);
+    int i = 0;
+
+    for (; i < rampLength; ++i)
+    {
+        stepRamp();
+        buffer[i] = filterSample(buffer[i]);
+    }
+
+    for (; i < numSamples; ++i)
     {
-        reset();
+        buffer[i] = filterSample(buffer[i]);
     }
 
+    if (!checkStability())
+    {
+        std::fill(buffer, buffer + numSamples, 0.0f);
+    }
+}
+
+bool MoogFilter::checkStability()
+{
+    // Written so NaN fails the comparison as well
+    auto withinLimit = [](float stage) { return std::abs(stage) <= STATE_LIMIT; };
+
+    if (withinLimit(stage1) && withinLimit(stage2) && withinLimit(stage3) && withinLimit(stage4))
+    {
+        return true;
+    }
+
+    reset();
+    ++instabilityResets;
+    return false;
+}
+
+void MoogFilter::stepRamp()
+{
+    if (--rampSamplesRemaining == 0)
+    {
+        // Land exactly on the target (no accumulated rounding)
+        g = rampTarget.g;
+        feedbackGain = rampTarget.feedbackGain;
+        outputGain = rampTarget.outputGain;
+    }
+    else
+    {
+        g += rampStep.g;
+        feedbackGain += rampStep.feedbackGain;
+        outputGain += rampStep.outputGain;
+    }
+}
+
+float MoogFilter::filterSample(float input)
+{
+    // No NaN checks or clamps in here: checkStability() runs once per block
+    return model == ZeroDelay ? zeroDelaySample(input) : classicSample(input);
+}
+
+float MoogFilter::classicSample(float input)
+{
     // Feedback from output to input (creates resonance peak)
     // Classic Moog ladder: feedback always from stage4 (final output)
     float inputWithFeedback = input - stage4 * feedbackGain;
 
     // Apply tanh saturation to input for analog warmth and low-end character
     // This prevents the filter from exploding at high resonance
-    float saturatedInput = std::tanh(inputWithFeedback);
+    float saturatedInput = AudioUtils::fastTanh(inputWithFeedback);
 
     // 4 one-pole lowpass stages in series (cascade)
     // Each stage smooths the signal: stage[n] += g * (input - stage[n])
@@ -72,12 +181,6 @@ float MoogFilter::processSample(float input)
     stage3 = stage3 + g * (stage2 - stage3);
     stage4 = stage4 + g * (stage3 - stage4);
 
-    // Clamp state variables to prevent overflow
-    stage1 = std::clamp(stage1, -10.0f, 10.0f);
-    stage2 = std::clamp(stage2, -10.0f, 10.0f);
-    stage3 = std::clamp(stage3, -10.0f, 10.0f);
-    stage4 = std::clamp(stage4, -10.0f, 10.0f);
-
     // Output depends on mode
     float output = 0.0f;
 
@@ -102,21 +205,57 @@ float MoogFilter::processSample(float input)
             break;
     }
 
-    // Resonance compensation: boost output volume at high resonance
-    // Frequency-dependent: less compensation at very high cutoffs to prevent volume drop
-    // At cutoff < 8kHz: full compensation, at 12kHz: minimal compensation
-    float cutoffRatio = std::clamp((12000.0f - cutoff) / 4000.0f, 0.2f, 1.0f);  // 1.0 at low freq, 0.2 at 12kHz
-    float resonanceCompensation = 1.0f + (feedbackGain * 0.15f * cutoffRatio);
-    output *= resonanceCompensation;
+    // Resonance compensation (precomputed in updateCoefficients)
+    return output * outputGain;
+}
+
+float MoogFilter::zeroDelaySample(float input)
+{
+    // TPT one-pole: v = G * (x - s), y = v + s, s' = y + v
+    // so y = G * x + (1 - G) * s, and the ladder output is
+    // y4 = G^4 * u + S with S = (1 - G) * (G^3 s1 + G^2 s2 + G s3 + s4).
+    // Solving u = x - k * y4 for u removes the unit delay from the feedback.
+    const float G = g;
+    const float G2 = G * G;
+    const float S = (1.0f - G) * (((G * stage1 + stage2) * G + stage3) * G + stage4);
+    const float inputWithFeedback = (input - feedbackGain * S) / (1.0f + feedbackGain * G2 * G2);
 
-    // Clamp output to prevent overflow
-    output = std::clamp(output, -10.0f, 10.0f);
+    // Saturate the ladder input (the feedback itself is solved linearly)
+    const float saturatedInput = AudioUtils::fastTanh(inputWithFeedback);
 
-    return output;
+    float v = (saturatedInput - stage1) * G;
+    const float y1 = v + stage1;
+    stage1 = y1 + v;
+
+    v = (y1 - stage2) * G;
+    const float y2 = v + stage2;
+    stage2 = y2 + v;
+
+    v = (y2 - stage3) * G;
+    const float y3 = v + stage3;
+    stage3 = y3 + v;
+
+    v = (y3 - stage4) * G;
+    const float y4 = v + stage4;
+    stage4 = y4 + v;
+
+    // Same mode taps as the classic ladder
+    float output = 0.0f;
+
+    switch (mode)
+    {
+        case LowPass:  output = y4; break;
+        case BandPass: output = y1 - y4; break;
+        case HighPass: output = inputWithFeedback - y4; break;
+    }
+
+    return output * outputGain;
 }
 
-void MoogFilter::updateCoefficients()
+MoogFilter::Coefficients MoogFilter::computeCoefficients() const
 {
+    Coefficients c;
+
     // Normalize cutoff to Nyquist frequency (0.0 - 0.5)
     // Clamp to well below Nyquist to prevent instability
     // 0.45 is safe maximum (0.499 causes tan(π/2) → infinity!)
@@ -124,11 +263,28 @@ void MoogFilter::updateCoefficients()
 
     // Use tan() for frequency warping (bilinear transform pre-warping)
     // This gives the aggressive low-end character preferred by user
-    g = std::tan(static_cast<float>(M_PI) * normalizedCutoff);
+    float warped = AudioUtils::fastTan(static_cast<float>(M_PI) * normalizedCutoff);
 
     // Clamp g to prevent extreme values
-    // At normalizedCutoff = 0.45, g ≈ 4.7, which is safe
-    g = std::clamp(g, 0.0f, 10.0f);
+    // At normalizedCutoff = 0.45, g ≈ 6.3, which is safe
+    warped = std::clamp(warped, 0.0f, 10.0f);
+
+    if (model == ZeroDelay)
+    {
+        // The solved loop has no extra phase shift, so feedback 4 is the exact
+        // self-oscillation point at every cutoff (tanh bounds the amplitude)
+        c.g = warped / (1.0f + warped);
+        c.feedbackGain = resonance * 4.0f;
+
+        // Passband loss is 1 / (1 + k); partial compensation keeps the level
+        // close to the classic model at full resonance
+        c.outputGain = 1.0f + c.feedbackGain * 0.25f;
+        return c;
+    }
+
+    // The explicit one-pole stages go unstable above g ≈ 1.5. 1.2 still
+    // covers 12 kHz at 44.1 kHz; lower sample rates get a lower top cutoff.
+    c.g = std::min(warped, 1.2f);
 
     // Resonance to feedback gain
     // Range: 0.0 - 3.5 (empirically chosen for good resonance without instability)
@@ -142,7 +298,23 @@ void MoogFilter::updateCoefficients()
         highCutoffReduction = std::clamp(highCutoffReduction, 0.6f, 1.0f);
     }
 
-    feedbackGain = resonance * 3.5f * highCutoffReduction;
+    c.feedbackGain = resonance * 3.5f * highCutoffReduction;
+
+    // Resonance compensation: boost output volume at high resonance
+    // Frequency-dependent: less compensation at very high cutoffs to prevent volume drop
+    // At cutoff < 8kHz: full compensation, at 12kHz: minimal compensation
+    float cutoffRatio = std::clamp((12000.0f - cutoff) / 4000.0f, 0.2f, 1.0f);  // 1.0 at low freq, 0.2 at 12kHz
+    c.outputGain = 1.0f + (c.feedbackGain * 0.15f * cutoffRatio);
+
+    return c;
+}
+
+void MoogFilter::updateCoefficients()
+{
+    const Coefficients c = computeCoefficients();
+    g = c.g;
+    feedbackGain = c.feedbackGain;
+    outputGain = c.outputGain;
 
     coefficientsNeedUpdate = false;
 }
@@ -5,15 +5,25 @@
 /**
  * MoogFilter - 4-pole Moog ladder filter
  *
- * Classic Moog lowpass topology with three modes:
+ * Classic Moog lowpass topology with two models and three modes:
  * - LowPass: 24dB/octave rolloff (classic Moog sound)
  * - BandPass: 12dB/octave bandpass (isolates mid frequencies)
  * - HighPass: High-pass by subtraction (removes bass)
  *
+ * Models:
+ * - Classic: one-pole stages with unit-delay feedback (the original sound)
+ * - ZeroDelay: topology-preserving transform (TPT) stages with the feedback
+ *   loop solved instantaneously, so the resonant peak stays on the cutoff
+ *   up to high frequencies and full resonance is the self-oscillation point
+ *
  * Features:
  * - Resonance control (0.0 - 1.0) creates peak at cutoff frequency
  * - Tanh saturation for analog warmth and stability
+ * - Block-level stability check: runaway or NaN state is reset after the
+ *   block instead of being tested and clamped every sample
  * - Coefficient caching for performance
+ * - Coefficient ramps (rampTo) so modulation can update cutoff and
+ *   resonance at control rate instead of every sample
  *
  * Signal flow:
  * Input → [Feedback] → 4 one-pole stages → Output
@@ -30,6 +40,12 @@ public:
         HighPass = 2   // High-pass by subtraction (input - stage 4)
     };
 
+    enum Model
+    {
+        Classic = 0,   // Unit-delay feedback ladder
+        ZeroDelay = 1  // Zero-delay-feedback (TPT) ladder
+    };
+
     MoogFilter();
 
     /**
@@ -42,26 +58,63 @@ public:
      * Filter parameters
      */
     void setMode(Mode mode);
+    void setModel(Model model);
     void setCutoff(float cutoffHz);        // 20.0 - 12000.0 Hz
     void setResonance(float resonance);    // 0.0 - 1.0
 
+    /**
+     * Move cutoff and resonance to new values over the next numSamples samples
+     * Coefficients are computed once for the target and linearly interpolated
+     * per sample, which is how LFO modulation reaches the filter at control rate.
+     * setCutoff/setResonance cancel a running ramp.
+     */
+    void rampTo(float cutoffHz, float resonance, int numSamples);
+
     /**
      * Audio processing
+     * No stability check in here: call checkStability() once per block of
+     * samples (Voice::processSample() does every MAX_BLOCK_SIZE samples).
      * @param input Audio sample to filter
      * @return Filtered sample
      */
     float processSample(float input);
 
+    /**
+     * Reset the stages if they are NaN/infinite or beyond STATE_LIMIT
+     * (processBlock() does this itself once per block)
+     * @return false if the state had to be reset
+     */
+    bool checkStability();
+
+    /**
+     * Filter a block of samples in place
+     * Coefficients are refreshed once per block instead of checked per sample.
+     * If the state ran away during the block, it is reset and the block is
+     * silenced.
+     * @param buffer Samples to filter (overwritten with filtered output)
+     * @param numSamples Number of samples in buffer
+     */
+    void processBlock(float* buffer, int numSamples);
+
     /**
      * Getters
      */
     Mode getMode() const { return mode; }
+    Model getModel() const { return model; }
     float getCutoff() const { return cutoff; }
     float getResonance() const { return resonance; }
 
+    /**
+     * Number of times the state blew up and was reset (never cleared)
+     */
+    int getInstabilityResets() const { return instabilityResets; }
+
 private:
-    // Filter mode
+    friend class VoiceLanes;  // Loads/stores stage state for voice-parallel rendering
+
+    // Filter mode and model
     Mode mode = LowPass;
+    Model model = Classic;
 
     // Sample rate
     double sampleRate = 44100.0;
@@ -76,13 +129,48 @@ private:
     float stage3 = 0.0f;
     float stage4 = 0.0f;
 
+    // Stability check: the tanh-limited input keeps a stable ladder's stages
+    // within a few units, so anything beyond this (or NaN) means it diverged
+    static constexpr float STATE_LIMIT = 100.0f;
+    int instabilityResets = 0;
+
     // Cached coefficients (only recalculate when parameters change)
-    float g = 0.0f;              // Cutoff coefficient
+    float g = 0.0f;              // Cutoff coefficient (ZeroDelay: g / (1 + g), the TPT gain)
     float feedbackGain = 0.0f;   // Resonance feedback amount
+    float outputGain = 1.0f;     // Resonance compensation
     bool coefficientsNeedUpdate = true;
 
+    struct Coefficients
+    {
+        float g = 0.0f;
+        float feedbackGain = 0.0f;
+        float outputGain = 1.0f;
+    };
+
+    // Coefficient ramp (rampTo)
+    Coefficients rampStep;       // Added per sample
+    Coefficients rampTarget;     // Set exactly on the last ramp sample
+    int rampSamplesRemaining = 0;
+
+    /**
+     * Coefficients for the current cutoff, resonance, model and sample rate
+     */
+    Coefficients computeCoefficients() const;
+
     /**
      * Update filter coefficients when cutoff or resonance changes
      */
     void updateCoefficients();
+
+    /**
+     * Advance a running coefficient ramp by one sample
+     */
+    void stepRamp();
+
+    /**
+     * Run one sample through the ladder using the current coefficients
+     */
+    float filterSample(float input);
+    float classicSample(float input);
+    float zeroDelaySample(float input);
 };
@@ -1,5 +1,4 @@
 #include "NoiseGenerator.h"
-#include <cstdlib>
 #include <cmath>
 
 NoiseGenerator::NoiseGenerator()
@@ -31,6 +30,11 @@ void NoiseGenerator::reset()
     brownState = 0.0f;
 }
 
+void NoiseGenerator::setSeed(uint32_t seed)
+{
+    random.setSeed(seed);
+}
+
 float NoiseGenerator::processSample()
 {
     switch (noiseType)
@@ -39,16 +43,39 @@ float NoiseGenerator::processSample()
             return generateWhite();
 
         case NoiseType::Pink:
-            return generatePink();
+            return generatePink(random.nextBipolar());
 
         case NoiseType::Brown:
-            return generateBrown();
+            return generateBrown(random.nextBipolar());
 
         default:
             return 0.0f;
     }
 }
 
+void NoiseGenerator::processBlock(float* output, int numSamples)
+{
+    // White noise for the whole block in one vectorized pass,
+    // then filtered in place for the coloured types
+    random.fillBipolar(output, numSamples);
+
+    switch (noiseType)
+    {
+        case NoiseType::White:
+            break;
+
+        case NoiseType::Pink:
+            for (int i = 0; i < numSamples; ++i)
+                output[i] = generatePink(output[i]);
+            break;
+
+        case NoiseType::Brown:
+            for (int i = 0; i < numSamples; ++i)
+                output[i] = generateBrown(output[i]);
+            break;
+    }
+}
+
 // ============================================================================
 // Noise Generators
 // ============================================================================
@@ -57,10 +84,10 @@ float NoiseGenerator::generateWhite()
 {
     // White noise: equal energy per frequency
     // Simple random values in range [-1, +1]
-    return randomFloat();
+    return random.nextBipolar();
 }
 
-float NoiseGenerator::generatePink()
+float NoiseGenerator::generatePink(float white)
 {
     // Pink noise generator using Paul Kellett's algorithm
     // This creates 1/f noise by summing multiple octaves of white noise
@@ -68,8 +95,6 @@ float NoiseGenerator::generatePink()
     //
     // Reference: http://www.firstpr.com.au/dsp/pink-noise/
 
-    float white = randomFloat();
-
     // Update running sums at different rates (powers of 2)
     pinkState0 = 0.99886f * pinkState0 + white * 0.0555179f;
     pinkState1 = 0.99332f * pinkState1 + white * 0.0750759f;
@@ -89,14 +114,12 @@ float NoiseGenerator::generatePink()
     return pink;
 }
 
-float NoiseGenerator::generateBrown()
+float NoiseGenerator::generateBrown(float white)
 {
     // Brown noise (Brownian noise): 1/f² spectrum
     // Generated by integrating white noise (simple low-pass filter)
     // Also called "red noise" or "random walk noise"
 
-    float white = randomFloat();
-
     // Integrate white noise with leaky integrator to prevent DC drift
     // The 0.02 term adds the new sample
     // The 0.998 term provides the integration (low-pass filtering)
@@ -109,9 +132,3 @@ float NoiseGenerator::generateBrown()
     // Scale for better output level
     return brownState * 3.5f;
 }
-
-float NoiseGenerator::randomFloat()
-{
-    // Generate random float in range [-1, +1]
-    return (static_cast<float>(std::rand()) / RAND_MAX) * 2.0f - 1.0f;
-}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "FastRandom.h"
+#include <cstdint>
+
 /**
  * NoiseGenerator - Global noise source for mixer channel
  *
@@ -41,11 +44,23 @@ public:
      */
     float processSample();
 
+    /**
+     * Generate a block of noise samples
+     * @param output Destination buffer (overwritten)
+     * @param numSamples Number of samples to generate
+     */
+    void processBlock(float* output, int numSamples);
+
     /**
      * Reset noise generator state
      */
     void reset();
 
+    /**
+     * Restart the random sequence (each generator has its own)
+     */
+    void setSeed(uint32_t seed);
+
 private:
     double sampleRate = 44100.0;
     NoiseType noiseType = NoiseType::White;
@@ -63,11 +78,11 @@ private:
     // Brown noise state (integrated white noise)
     float brownState = 0.0f;
 
-    // Noise generators
-    float generateWhite();
-    float generatePink();
-    float generateBrown();
+    // White noise source
+    FastRandom random;
 
-    // Helper: Generate random float in range [-1, +1]
-    float randomFloat();
+    // Noise generators (pink and brown filter a white sample)
+    float generateWhite();
+    float generatePink(float white);
+    float generateBrown(float white);
 };
@@ -1,11 +1,8 @@
 #include "Oscillator.h"
 #include <cmath>
 
-#ifndef M_PI
-    #define M_PI 3.14159265358979323846
-#endif
-
 Oscillator::Oscillator()
+    : tables(LookupTables::acquire())
 {
     updatePhaseIncrement();
 }
@@ -32,17 +29,41 @@ void Oscillator::setPulseWidth(float pw)
     pulseWidth = AudioUtils::clamp(pw, 0.01f, 0.99f);
 }
 
+void Oscillator::setEngine(Engine newEngine)
+{
+    engine = newEngine;
+}
+
 void Oscillator::updatePhaseIncrement()
 {
     // Phase increment = frequency / sampleRate
     // This gives us how much phase advances per sample
     phaseIncrement = frequency / sampleRate;
+
+    // Highest-resolution table that doesn't alias at this frequency
+    tableLevel = Wavetable::levelForIncrement(phaseIncrement);
+}
+
+void Oscillator::advancePhase()
+{
+    // Advance phase
+    phase += phaseIncrement;
+
+    // Wrap phase to 0.0-1.0 range
+    AudioUtils::wrapPhase(phase);
 }
 
 float Oscillator::processSample()
 {
     float sample = 0.0f;
 
+    if (engine == Engine::Wavetable)
+    {
+        sample = generateFromWavetable();
+        advancePhase();
+        return sample;
+    }
+
     // Generate waveform based on current selection
     switch (waveform)
     {
@@ -63,25 +84,70 @@ float Oscillator::processSample()
             break;
     }
 
-    // Advance phase
-    phase += phaseIncrement;
-
-    // Wrap phase to 0.0-1.0 range
-    AudioUtils::wrapPhase(phase);
+    advancePhase();
 
     return sample;
 }
 
+void Oscillator::processBlock(float* output, int numSamples)
+{
+    if (engine == Engine::Wavetable)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            output[i] = generateFromWavetable();
+            advancePhase();
+        }
+        return;
+    }
+
+    // Waveform is fixed for the whole block, so dispatch once and run a tight loop
+    switch (waveform)
+    {
+        case Waveform::Sine:
+            for (int i = 0; i < numSamples; ++i)
+            {
+                output[i] = generateSine();
+                advancePhase();
+            }
+            break;
+
+        case Waveform::Sawtooth:
+            for (int i = 0; i < numSamples; ++i)
+            {
+                output[i] = generateSawtooth();
+                advancePhase();
+            }
+            break;
+
+        case Waveform::Square:
+            for (int i = 0; i < numSamples; ++i)
+            {
+                output[i] = generateSquare();
+                advancePhase();
+            }
+            break;
+
+        case Waveform::Triangle:
+            for (int i = 0; i < numSamples; ++i)
+            {
+                output[i] = generateTriangle();
+                advancePhase();
+            }
+            break;
+    }
+}
+
 void Oscillator::reset()
 {
     phase = 0.0;
 }
 
-void Oscillator::setRandomPhase()
+void Oscillator::setRandomPhase(FastRandom& random)
 {
     // Set phase to random value between 0.0 and 1.0
     // Breaks phase synchronization for more natural unison sound
-    phase = static_cast<double>(rand()) / static_cast<double>(RAND_MAX);
+    phase = static_cast<double>(random.nextFloat());
 }
 
 // ============================================================================
@@ -91,7 +157,7 @@ void Oscillator::setRandomPhase()
 float Oscillator::generateSine()
 {
     // Pure sine wave - no aliasing, no PolyBLEP needed
-    return std::sin(phase * 2.0 * M_PI);
+    return tables->sine(phase);
 }
 
 float Oscillator::generateSawtooth()
@@ -162,3 +228,32 @@ float Oscillator::generateTriangle()
 
     return naiveTriangle + polyBlepCorrection;
 }
+
+float Oscillator::wavetableSample(const Wavetable& wavetable, Waveform waveform, int level, double phase, float pulseWidth)
+{
+    switch (waveform)
+    {
+        case Waveform::Sine:
+            return wavetable.lookup(Wavetable::Sine, level, phase);
+
+        case Waveform::Sawtooth:
+            return wavetable.lookup(Wavetable::Sawtooth, level, phase);
+
+        case Waveform::Square:
+        {
+            // Pulse = difference of two band-limited saws offset by the pulse width
+            // (+1 while phase < pulseWidth, -1 after), plus its DC offset
+            double phaseShifted = phase - pulseWidth;
+            if (phaseShifted < 0.0)
+                phaseShifted += 1.0;
+
+            return wavetable.lookup(Wavetable::Sawtooth, level, phaseShifted)
+                 - wavetable.lookup(Wavetable::Sawtooth, level, phase)
+                 + 2.0f * pulseWidth - 1.0f;
+        }
+
+        case Waveform::Triangle:
+        default:
+            return wavetable.lookup(Wavetable::Triangle, level, phase);
+    }
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "AudioUtils.h"
+#include "FastRandom.h"
+#include "LookupTables.h"
 
 /**
  * Oscillator - Waveform generator with PolyBLEP anti-aliasing
@@ -11,6 +13,12 @@
  * - Square: Hollow waveform with pulse width modulation and PolyBLEP
  * - Triangle: Smooth, mellow waveform with PolyBLEP
  *
+ * Two engines render the same waveforms:
+ * - PolyBLEP: naive waveform plus per-sample discontinuity correction
+ * - Wavetable: interpolated reads from shared band-limited mipmaps
+ *
+ * Sine and wavetables come from the process-wide LookupTables.
+ *
  * Note: Noise is handled separately via NoiseGenerator for mixer control
  *
  * Python reference: sine_generator_qt.py:3555-3615 (generate_waveform)
@@ -26,6 +34,12 @@ public:
         Triangle = 3
     };
 
+    enum class Engine
+    {
+        PolyBLEP = 0,
+        Wavetable = 1
+    };
+
     Oscillator();
 
     /**
@@ -52,12 +66,33 @@ public:
      */
     void setPulseWidth(float pw);
 
+    /**
+     * Select how waveforms are generated
+     * @param engine PolyBLEP (default) or Wavetable
+     */
+    void setEngine(Engine engine);
+
     /**
      * Generate one audio sample
      * @return Audio sample in range -1.0 to +1.0
      */
     float processSample();
 
+    /**
+     * Generate a block of audio samples
+     * Waveform dispatch happens once per block instead of once per sample
+     * @param output Destination buffer (overwritten)
+     * @param numSamples Number of samples to generate
+     */
+    void processBlock(float* output, int numSamples);
+
+    /**
+     * One wavetable-engine sample (shared with the voice-parallel renderer)
+     * @param level Mip level from Wavetable::levelForIncrement
+     * @param phase Phase in [0, 1)
+     */
+    static float wavetableSample(const Wavetable& wavetable, Waveform waveform, int level, double phase, float pulseWidth);
+
     /**
      * Reset oscillator phase to 0
      */
@@ -65,10 +100,13 @@ public:
 
     /**
      * Set random phase offset (0.0 - 1.0) to break phase synchronization
+     * @param random Generator of the owning voice
      */
-    void setRandomPhase();
+    void setRandomPhase(FastRandom& random);
 
 private:
+    friend class VoiceLanes;  // Loads/stores phase state for voice-parallel rendering
+
     // Oscillator state
     double phase = 0.0;              // Current phase (0.0 to 1.0)
     double phaseIncrement = 0.0;     // Phase increment per sample
@@ -79,12 +117,21 @@ private:
     Waveform waveform = Waveform::Sine;
     float pulseWidth = 0.5f;
 
+    // Shared sine table and wavetables
+    std::shared_ptr<const LookupTables> tables;
+
+    // Wavetable engine
+    Engine engine = Engine::PolyBLEP;
+    int tableLevel = 0;              // Mip level for the current phase increment
+
     // Waveform generators
     float generateSine();
     float generateSawtooth();
     float generateSquare();
     float generateTriangle();
+    float generateFromWavetable() { return wavetableSample(tables->getWavetable(), waveform, tableLevel, phase, pulseWidth); }
 
     // Helper methods
     void updatePhaseIncrement();
+    void advancePhase();
 };
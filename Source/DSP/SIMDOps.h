@@ -0,0 +1,331 @@
+#pragma once
+
+#include "AudioUtils.h"
+#include <cstdint>
+
+// Exactly one of these is 1 (all 0 selects the scalar fallback)
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define CLEMMY3_SIMD_AVX 1
+    #define CLEMMY3_SIMD_SSE 0
+    #define CLEMMY3_SIMD_NEON 0
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define CLEMMY3_SIMD_AVX 0
+    #define CLEMMY3_SIMD_SSE 1
+    #define CLEMMY3_SIMD_NEON 0
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define CLEMMY3_SIMD_AVX 0
+    #define CLEMMY3_SIMD_SSE 0
+    #define CLEMMY3_SIMD_NEON 1
+#else
+    #define CLEMMY3_SIMD_AVX 0
+    #define CLEMMY3_SIMD_SSE 0
+    #define CLEMMY3_SIMD_NEON 0
+#endif
+
+/**
+ * SIMDOps - Minimal float lane vector for voice-parallel processing
+ *
+ * FloatVec holds one float per voice lane:
+ * - AVX:  8 lanes (__m256)
+ * - SSE2: 4 lanes (__m128)
+ * - NEON: 4 lanes (float32x4_t)
+ * - Otherwise: 4 lanes of plain scalar code
+ *
+ * Comparisons return a FloatMask that can be combined with & | and used in
+ * select(), so per-lane branches become branch-free blends.
+ */
+namespace SIMDOps
+{
+#if CLEMMY3_SIMD_AVX
+    struct FloatMask { __m256 m; };
+
+    struct FloatVec
+    {
+        static constexpr int size = 8;
+        __m256 v;
+
+        static FloatVec load(const float* p)    { return { _mm256_loadu_ps(p) }; }
+        static FloatVec broadcast(float x)      { return { _mm256_set1_ps(x) }; }
+        void store(float* p) const              { _mm256_storeu_ps(p, v); }
+    };
+
+    inline FloatVec operator+(FloatVec a, FloatVec b) { return { _mm256_add_ps(a.v, b.v) }; }
+    inline FloatVec operator-(FloatVec a, FloatVec b) { return { _mm256_sub_ps(a.v, b.v) }; }
+    inline FloatVec operator*(FloatVec a, FloatVec b) { return { _mm256_mul_ps(a.v, b.v) }; }
+    inline FloatVec operator/(FloatVec a, FloatVec b) { return { _mm256_div_ps(a.v, b.v) }; }
+    inline FloatVec min(FloatVec a, FloatVec b)       { return { _mm256_min_ps(a.v, b.v) }; }
+    inline FloatVec max(FloatVec a, FloatVec b)       { return { _mm256_max_ps(a.v, b.v) }; }
+
+    inline FloatMask operator<(FloatVec a, FloatVec b)  { return { _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) }; }
+    inline FloatMask operator<=(FloatVec a, FloatVec b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ) }; }
+    inline FloatMask operator>(FloatVec a, FloatVec b)  { return { _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ) }; }
+    inline FloatMask operator>=(FloatVec a, FloatVec b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ) }; }
+    inline FloatMask operator==(FloatVec a, FloatVec b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ) }; }
+    inline FloatMask operator&(FloatMask a, FloatMask b) { return { _mm256_and_ps(a.m, b.m) }; }
+    inline FloatMask operator|(FloatMask a, FloatMask b) { return { _mm256_or_ps(a.m, b.m) }; }
+
+    inline FloatVec select(FloatMask mask, FloatVec ifTrue, FloatVec ifFalse)
+    {
+        return { _mm256_blendv_ps(ifFalse.v, ifTrue.v, mask.m) };
+    }
+
+    inline bool anyOf(FloatMask mask)      { return _mm256_movemask_ps(mask.m) != 0; }
+    inline bool laneOf(FloatMask mask, int lane) { return ((_mm256_movemask_ps(mask.m) >> lane) & 1) != 0; }
+
+    inline float sum(FloatVec a)
+    {
+        __m128 s = _mm_add_ps(_mm256_castps256_ps128(a.v), _mm256_extractf128_ps(a.v, 1));
+        s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+        s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+        return _mm_cvtss_f32(s);
+    }
+
+#elif CLEMMY3_SIMD_SSE
+    struct FloatMask { __m128 m; };
+
+    struct FloatVec
+    {
+        static constexpr int size = 4;
+        __m128 v;
+
+        static FloatVec load(const float* p)    { return { _mm_loadu_ps(p) }; }
+        static FloatVec broadcast(float x)      { return { _mm_set1_ps(x) }; }
+        void store(float* p) const              { _mm_storeu_ps(p, v); }
+    };
+
+    inline FloatVec operator+(FloatVec a, FloatVec b) { return { _mm_add_ps(a.v, b.v) }; }
+    inline FloatVec operator-(FloatVec a, FloatVec b) { return { _mm_sub_ps(a.v, b.v) }; }
+    inline FloatVec operator*(FloatVec a, FloatVec b) { return { _mm_mul_ps(a.v, b.v) }; }
+    inline FloatVec operator/(FloatVec a, FloatVec b) { return { _mm_div_ps(a.v, b.v) }; }
+    inline FloatVec min(FloatVec a, FloatVec b)       { return { _mm_min_ps(a.v, b.v) }; }
+    inline FloatVec max(FloatVec a, FloatVec b)       { return { _mm_max_ps(a.v, b.v) }; }
+
+    inline FloatMask operator<(FloatVec a, FloatVec b)  { return { _mm_cmplt_ps(a.v, b.v) }; }
+    inline FloatMask operator<=(FloatVec a, FloatVec b) { return { _mm_cmple_ps(a.v, b.v) }; }
+    inline FloatMask operator>(FloatVec a, FloatVec b)  { return { _mm_cmpgt_ps(a.v, b.v) }; }
+    inline FloatMask operator>=(FloatVec a, FloatVec b) { return { _mm_cmpge_ps(a.v, b.v) }; }
+    inline FloatMask operator==(FloatVec a, FloatVec b) { return { _mm_cmpeq_ps(a.v, b.v) }; }
+    inline FloatMask operator&(FloatMask a, FloatMask b) { return { _mm_and_ps(a.m, b.m) }; }
+    inline FloatMask operator|(FloatMask a, FloatMask b) { return { _mm_or_ps(a.m, b.m) }; }
+
+    inline FloatVec select(FloatMask mask, FloatVec ifTrue, FloatVec ifFalse)
+    {
+        // SSE2 has no blend instruction: (mask & a) | (~mask & b)
+        return { _mm_or_ps(_mm_and_ps(mask.m, ifTrue.v), _mm_andnot_ps(mask.m, ifFalse.v)) };
+    }
+
+    inline bool anyOf(FloatMask mask)      { return _mm_movemask_ps(mask.m) != 0; }
+    inline bool laneOf(FloatMask mask, int lane) { return ((_mm_movemask_ps(mask.m) >> lane) & 1) != 0; }
+
+    inline float sum(FloatVec a)
+    {
+        __m128 s = _mm_add_ps(a.v, _mm_movehl_ps(a.v, a.v));
+        s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+        return _mm_cvtss_f32(s);
+    }
+
+#elif CLEMMY3_SIMD_NEON
+    struct FloatMask { uint32x4_t m; };
+
+    struct FloatVec
+    {
+        static constexpr int size = 4;
+        float32x4_t v;
+
+        static FloatVec load(const float* p)    { return { vld1q_f32(p) }; }
+        static FloatVec broadcast(float x)      { return { vdupq_n_f32(x) }; }
+        void store(float* p) const              { vst1q_f32(p, v); }
+    };
+
+    inline FloatVec operator+(FloatVec a, FloatVec b) { return { vaddq_f32(a.v, b.v) }; }
+    inline FloatVec operator-(FloatVec a, FloatVec b) { return { vsubq_f32(a.v, b.v) }; }
+    inline FloatVec operator*(FloatVec a, FloatVec b) { return { vmulq_f32(a.v, b.v) }; }
+    inline FloatVec min(FloatVec a, FloatVec b)       { return { vminq_f32(a.v, b.v) }; }
+    inline FloatVec max(FloatVec a, FloatVec b)       { return { vmaxq_f32(a.v, b.v) }; }
+
+    inline FloatVec operator/(FloatVec a, FloatVec b)
+    {
+       #if defined(__aarch64__) || defined(_M_ARM64)
+        return { vdivq_f32(a.v, b.v) };
+       #else
+        // ARMv7: reciprocal estimate refined with two Newton-Raphson steps
+        float32x4_t r = vrecpeq_f32(b.v);
+        r = vmulq_f32(vrecpsq_f32(b.v, r), r);
+        r = vmulq_f32(vrecpsq_f32(b.v, r), r);
+        return { vmulq_f32(a.v, r) };
+       #endif
+    }
+
+    inline FloatMask operator<(FloatVec a, FloatVec b)  { return { vcltq_f32(a.v, b.v) }; }
+    inline FloatMask operator<=(FloatVec a, FloatVec b) { return { vcleq_f32(a.v, b.v) }; }
+    inline FloatMask operator>(FloatVec a, FloatVec b)  { return { vcgtq_f32(a.v, b.v) }; }
+    inline FloatMask operator>=(FloatVec a, FloatVec b) { return { vcgeq_f32(a.v, b.v) }; }
+    inline FloatMask operator==(FloatVec a, FloatVec b) { return { vceqq_f32(a.v, b.v) }; }
+    inline FloatMask operator&(FloatMask a, FloatMask b) { return { vandq_u32(a.m, b.m) }; }
+    inline FloatMask operator|(FloatMask a, FloatMask b) { return { vorrq_u32(a.m, b.m) }; }
+
+    inline FloatVec select(FloatMask mask, FloatVec ifTrue, FloatVec ifFalse)
+    {
+        return { vbslq_f32(mask.m, ifTrue.v, ifFalse.v) };
+    }
+
+    inline bool laneOf(FloatMask mask, int lane)
+    {
+        uint32_t lanes[4];
+        vst1q_u32(lanes, mask.m);
+        return lanes[lane] != 0;
+    }
+
+    inline bool anyOf(FloatMask mask)
+    {
+        uint32x2_t folded = vorr_u32(vget_low_u32(mask.m), vget_high_u32(mask.m));
+        return (vget_lane_u32(folded, 0) | vget_lane_u32(folded, 1)) != 0;
+    }
+
+    inline float sum(FloatVec a)
+    {
+        float32x2_t s = vadd_f32(vget_low_f32(a.v), vget_high_f32(a.v));
+        return vget_lane_f32(vpadd_f32(s, s), 0);
+    }
+
+#else
+    // Scalar fallback with the same interface (compilers may still auto-vectorize it)
+    struct FloatMask { bool m[4]; };
+
+    struct FloatVec
+    {
+        static constexpr int size = 4;
+        float v[4];
+
+        static FloatVec load(const float* p)    { return { { p[0], p[1], p[2], p[3] } }; }
+        static FloatVec broadcast(float x)      { return { { x, x, x, x } }; }
+        void store(float* p) const              { for (int i = 0; i < 4; ++i) p[i] = v[i]; }
+    };
+
+    #define CLEMMY3_SIMD_SCALAR_BINARY(op, expr) \
+        inline FloatVec op(FloatVec a, FloatVec b) { FloatVec r; for (int i = 0; i < 4; ++i) r.v[i] = (expr); return r; }
+    #define CLEMMY3_SIMD_SCALAR_COMPARE(op, cmp) \
+        inline FloatMask op(FloatVec a, FloatVec b) { FloatMask r; for (int i = 0; i < 4; ++i) r.m[i] = a.v[i] cmp b.v[i]; return r; }
+
+    CLEMMY3_SIMD_SCALAR_BINARY(operator+, a.v[i] + b.v[i])
+    CLEMMY3_SIMD_SCALAR_BINARY(operator-, a.v[i] - b.v[i])
+    CLEMMY3_SIMD_SCALAR_BINARY(operator*, a.v[i] * b.v[i])
+    CLEMMY3_SIMD_SCALAR_BINARY(operator/, a.v[i] / b.v[i])
+    CLEMMY3_SIMD_SCALAR_BINARY(min, a.v[i] < b.v[i] ? a.v[i] : b.v[i])
+    CLEMMY3_SIMD_SCALAR_BINARY(max, a.v[i] > b.v[i] ? a.v[i] : b.v[i])
+    CLEMMY3_SIMD_SCALAR_COMPARE(operator<, <)
+    CLEMMY3_SIMD_SCALAR_COMPARE(operator<=, <=)
+    CLEMMY3_SIMD_SCALAR_COMPARE(operator>, >)
+    CLEMMY3_SIMD_SCALAR_COMPARE(operator>=, >=)
+    CLEMMY3_SIMD_SCALAR_COMPARE(operator==, ==)
+
+    #undef CLEMMY3_SIMD_SCALAR_BINARY
+    #undef CLEMMY3_SIMD_SCALAR_COMPARE
+
+    inline FloatMask operator&(FloatMask a, FloatMask b) { FloatMask r; for (int i = 0; i < 4; ++i) r.m[i] = a.m[i] && b.m[i]; return r; }
+    inline FloatMask operator|(FloatMask a, FloatMask b) { FloatMask r; for (int i = 0; i < 4; ++i) r.m[i] = a.m[i] || b.m[i]; return r; }
+
+    inline FloatVec select(FloatMask mask, FloatVec ifTrue, FloatVec ifFalse)
+    {
+        FloatVec r;
+        for (int i = 0; i < 4; ++i)
+            r.v[i] = mask.m[i] ? ifTrue.v[i] : ifFalse.v[i];
+        return r;
+    }
+
+    inline bool anyOf(FloatMask mask)            { return mask.m[0] || mask.m[1] || mask.m[2] || mask.m[3]; }
+    inline bool laneOf(FloatMask mask, int lane) { return mask.m[lane]; }
+    inline float sum(FloatVec a)                 { return (a.v[0] + a.v[1]) + (a.v[2] + a.v[3]); }
+#endif
+
+    //==========================================================================
+    // Lane math built on the primitives above
+    //==========================================================================
+
+    inline FloatVec clamp(FloatVec x, float lo, float hi)
+    {
+        return min(max(x, FloatVec::broadcast(lo)), FloatVec::broadcast(hi));
+    }
+
+    /**
+     * sin(2 * pi * phase) for phase in [0, 1)
+     * Folds the phase into a quarter cycle and evaluates an odd Taylor series
+     * up to x^11 (max error ~2e-7, i.e. float rounding)
+     */
+    inline FloatVec sinCycle(FloatVec phase)
+    {
+        const FloatVec half = FloatVec::broadcast(0.5f);
+        const FloatVec quarter = FloatVec::broadcast(0.25f);
+
+        // [0, 1) -> [-0.5, 0.5) with sign flip: sin(2pi p) = -sin(2pi (p - 0.5))
+        FloatVec x = phase - half;
+
+        // Fold |x| > 0.25 back onto the rising quarter: sin(2pi x) = sin(2pi (+-0.5 - x))
+        x = select(x > quarter, half - x, x);
+        x = select(x < FloatVec::broadcast(-0.25f), FloatVec::broadcast(-0.5f) - x, x);
+
+        const FloatVec a = x * FloatVec::broadcast(6.28318530718f);
+        const FloatVec a2 = a * a;
+
+        FloatVec p = FloatVec::broadcast(-2.50521083854e-8f);        // -1/11!
+        p = p * a2 + FloatVec::broadcast(2.75573192240e-6f);         //  1/9!
+        p = p * a2 + FloatVec::broadcast(-1.98412698413e-4f);        // -1/7!
+        p = p * a2 + FloatVec::broadcast(8.33333333333e-3f);         //  1/5!
+        p = p * a2 + FloatVec::broadcast(-1.66666666667e-1f);        // -1/3!
+        p = p * a2 + FloatVec::broadcast(1.0f);
+
+        return FloatVec::broadcast(0.0f) - a * p;
+    }
+
+    /**
+     * tan(x) for x in [0, 1.42] (Moog cutoff prewarping up to 0.45 * sample rate)
+     * [5/4] Pade approximant, same as AudioUtils::fastTan
+     */
+    inline FloatVec tan(FloatVec x)
+    {
+        const FloatVec x2 = x * x;
+
+        FloatVec num = x2 - FloatVec::broadcast(105.0f);
+        num = (num * x2 + FloatVec::broadcast(945.0f)) * x;
+
+        FloatVec den = FloatVec::broadcast(15.0f) * x2 - FloatVec::broadcast(420.0f);
+        den = den * x2 + FloatVec::broadcast(945.0f);
+
+        return num / den;
+    }
+
+    /**
+     * tanh(x) via the [7/6] Pade approximant, input clamped to +-4.97
+     * where the approximant reaches 1
+     * Max error 1e-4 at the clamp point, below 1e-6 for |x| < 3
+     * (std::tanh per lane when CLEMMY3_EXACT_TANH is set)
+     */
+    inline FloatVec tanh(FloatVec x)
+    {
+       #if CLEMMY3_EXACT_TANH
+        float lanes[FloatVec::size];
+        x.store(lanes);
+
+        for (float& lane : lanes)
+            lane = std::tanh(lane);
+
+        return FloatVec::load(lanes);
+       #else
+        x = clamp(x, -4.97f, 4.97f);
+        const FloatVec x2 = x * x;
+
+        FloatVec num = x2 + FloatVec::broadcast(378.0f);
+        num = num * x2 + FloatVec::broadcast(17325.0f);
+        num = (num * x2 + FloatVec::broadcast(135135.0f)) * x;
+
+        FloatVec den = FloatVec::broadcast(28.0f) * x2 + FloatVec::broadcast(3150.0f);
+        den = den * x2 + FloatVec::broadcast(62370.0f);
+        den = den * x2 + FloatVec::broadcast(135135.0f);
+
+        return clamp(num / den, -1.0f, 1.0f);
+       #endif
+    }
+}
@@ -1,30 +1,49 @@
 #include "Voice.h"
 #include "AudioUtils.h"
+#include <algorithm>
 #include <cmath>
 
 Voice::Voice()
+    : tables(LookupTables::acquire())
 {
 }
 
 void Voice::setSampleRate(double newSampleRate)
 {
-    // Initialize all oscillators with sample rate
-    for (auto& osc : oscillators)
-    {
-        osc.setSampleRate(newSampleRate);
-    }
+    sampleRate = newSampleRate;
+
+    // Oscillators and filter run at the oversampled rate
+    setOversampling(oversamplingFactor);
 
     noiseGenerator.setSampleRate(newSampleRate);
-    filter.setSampleRate(newSampleRate);
     envelope.setSampleRate(newSampleRate);
     lfo1.setSampleRate(newSampleRate);
     lfo2.setSampleRate(newSampleRate);
 }
 
+void Voice::setOversampling(int factor)
+{
+    oversamplingFactor = factor >= 4 ? 4 : (factor >= 2 ? 2 : 1);
+    oversamplingShift = Oversampling::shiftForFactor(oversamplingFactor);
+
+    const double oversampledRate = sampleRate * oversamplingFactor;
+
+    for (auto& osc : oscillators)
+    {
+        osc.setSampleRate(oversampledRate);
+    }
+
+    filter.setSampleRate(oversampledRate);
+    decimator.reset();
+}
+
 void Voice::noteOn(int midiNote, float velocity, float detune, bool randomizePhase)
 {
     currentMidiNote = midiNote;
     unisonDetune = detune;
+    noteVelocity = velocity;
+    outputPeak = 0.0f;
+    silentSamples = 0;
 
     // Reset or randomize oscillator phases
     for (auto& osc : oscillators)
@@ -32,7 +51,7 @@ void Voice::noteOn(int midiNote, float velocity, float detune, bool randomizePha
         if (randomizePhase)
         {
             // Random phase for unison mode - prevents phaser effect
-            osc.setRandomPhase();
+            osc.setRandomPhase(random);
         }
         else
         {
@@ -50,9 +69,15 @@ void Voice::noteOn(int midiNote, float velocity, float detune, bool randomizePha
     // Reset LFO phases for note-synchronized modulation
     lfo1.reset();
     lfo2.reset();
+}
 
-    // Reset age for voice stealing
-    resetAge();
+void Voice::setRandomSeed(uint32_t seed)
+{
+    // Separate streams for the noise, the phases and each LFO
+    noiseGenerator.setSeed(seed);
+    random.setSeed(seed ^ 0xA5A5A5A5u);
+    lfo1.setSeed(seed ^ 0x3C3C3C3Cu);
+    lfo2.setSeed(seed ^ 0xC3C3C3C3u);
 }
 
 void Voice::noteOff()
@@ -74,14 +99,17 @@ void Voice::reset()
 
     // Reset filter state
     filter.reset();
+    decimator.reset();
 
     // Reset envelope to idle state
     envelope.reset();
 
     // Clear voice state
     currentMidiNote = -1;
-    age = 0;
+    startOrder = 0;
     unisonDetune = 0.0f;
+    outputPeak = 0.0f;
+    silentSamples = 0;
 }
 
 //==============================================================================
@@ -134,10 +162,19 @@ void Voice::setOscillatorPulseWidth(int oscIndex, float pw)
 {
     if (oscIndex >= 0 && oscIndex < NUM_OSCILLATORS)
     {
+        oscSettings[oscIndex].pulseWidth = pw;
         oscillators[oscIndex].setPulseWidth(pw);
     }
 }
 
+void Voice::setOscillatorEngine(int oscIndex, Oscillator::Engine engine)
+{
+    if (oscIndex >= 0 && oscIndex < NUM_OSCILLATORS)
+    {
+        oscillators[oscIndex].setEngine(engine);
+    }
+}
+
 void Voice::setOscillatorDrive(int oscIndex, float drive)
 {
     if (oscIndex >= 0 && oscIndex < NUM_OSCILLATORS)
@@ -183,6 +220,11 @@ void Voice::setFilterMode(MoogFilter::Mode mode)
     filter.setMode(mode);
 }
 
+void Voice::setFilterModel(MoogFilter::Model model)
+{
+    filter.setModel(model);
+}
+
 void Voice::setFilterCutoff(float cutoffHz)
 {
     baseFilterCutoff = cutoffHz;  // Store base value for modulation
@@ -216,7 +258,8 @@ void Voice::setLFO1Depth(float depth)
 
 void Voice::setLFO1Destination(int dest)
 {
-    lfo1Destination = static_cast<ModDestination>(dest);
+    modulation.setSlot(ModulationMatrix::LFO1_SLOT, ModulationMatrix::SourceLFO1,
+                       static_cast<ModulationMatrix::Destination>(dest), 1.0f);
 }
 
 void Voice::setLFO2Waveform(LFO::Waveform waveform)
@@ -236,7 +279,8 @@ void Voice::setLFO2Depth(float depth)
 
 void Voice::setLFO2Destination(int dest)
 {
-    lfo2Destination = static_cast<ModDestination>(dest);
+    modulation.setSlot(ModulationMatrix::LFO2_SLOT, ModulationMatrix::SourceLFO2,
+                       static_cast<ModulationMatrix::Destination>(dest), 1.0f);
 }
 
 void Voice::setLFO1RateMode(LFO::RateMode mode)
@@ -269,6 +313,42 @@ void Voice::setLFO2BPM(float bpm)
     lfo2.setBPM(bpm);
 }
 
+void Voice::setLFOTransportPosition(double ppqPosition)
+{
+    lfo1.setTransportPosition(ppqPosition);
+    lfo2.setTransportPosition(ppqPosition);
+}
+
+void Voice::setSharedLFOBuffer(int lfoIndex, const float* buffer)
+{
+    if (lfoIndex >= 0 && lfoIndex < 2)
+        sharedLFOBuffers[static_cast<size_t>(lfoIndex)] = buffer;
+}
+
+//==============================================================================
+// Modulation Matrix
+//==============================================================================
+
+void Voice::setModulationSlot(int userSlot, ModulationMatrix::Source source,
+                              ModulationMatrix::Destination destination, float amount)
+{
+    if (userSlot >= 0 && userSlot < ModulationMatrix::NUM_USER_SLOTS)
+    {
+        modulation.setSlot(ModulationMatrix::LFO2_SLOT + 1 + userSlot, source, destination,
+                           std::clamp(amount, -1.0f, 1.0f));
+    }
+}
+
+void Voice::setModWheel(float value)
+{
+    modWheel = std::clamp(value, 0.0f, 1.0f);
+}
+
+void Voice::setControlInterval(int numSamples)
+{
+    controlInterval = std::clamp(numSamples, 1, MAX_BLOCK_SIZE);
+}
+
 //==============================================================================
 // Audio Processing
 //==============================================================================
@@ -278,152 +358,389 @@ float Voice::processSample()
     if (!isActive())
         return 0.0f;
 
-    // Signal chain: LFOs → Modulation → Oscillators → Mix → Filter → Envelope → Volume Mod → Output
+    // Signal chain: LFOs + Envelope → Modulation → Oscillators → Mix → Filter → Envelope → Volume Mod → Output
 
-    // 1. Process LFOs and get modulation values
-    float lfo1Value = lfo1.processSample();  // -1 to +1, scaled by depth
-    float lfo2Value = lfo2.processSample();
+    // 1. Process modulation sources (LFOs -1 to +1 scaled by depth, envelope 0 to 1)
+    float lfo1Value = sharedLFOBuffers[0] != nullptr ? sharedLFOBuffers[0][0] : lfo1.processSample();
+    float lfo2Value = sharedLFOBuffers[1] != nullptr ? sharedLFOBuffers[1][0] : lfo2.processSample();
+    float envLevel = envelope.processSample();
 
-    // 2. Apply modulation to parameters
+    // 2. Evaluate the modulation matrix for this sample and apply it
+    using M = ModulationMatrix;
+    restoreUnmodulatedParameters(true);
 
-    // --- LFO1 Modulation ---
-    if (lfo1Destination == ModFilterCutoff)
+    if (modulation.isActive())
     {
-        // Modulate filter cutoff (±2 octaves range)
-        float modAmount = lfo1Value * baseFilterCutoff * 2.0f;
-        filter.setCutoff(std::clamp(baseFilterCutoff + modAmount, 20.0f, 12000.0f));
+        float destinations[M::NumDestinations];
+        evaluateModulation(lfo1Value, lfo2Value, envLevel, destinations);
+
+        for (int d = 0; d < M::NumDestinations; ++d)
+            modulationBuffers[static_cast<size_t>(d)][0] = destinations[d];
+
+        if (modulation.targetsAny(M::DestPitch, M::DestPWM))
+            applyOscillatorModulation(0);
+
+        if (modulation.targetsAny(M::DestFilterCutoff, M::DestFilterRes))
+            applyFilterModulation(0, 0);
     }
-    else if (lfo1Destination == ModFilterRes)
+
+    // 3-4. Mix all enabled oscillators + noise and filter the mix
+    //      (oversampled: several passes, decimated back to one sample)
+    const float noiseSample = noiseEnabled ? noiseGenerator.processSample() : 0.0f;
+    float oversampled[Oversampling::MAX_FACTOR];
+
+    for (int i = 0; i < oversamplingFactor; ++i)
+        oversampled[i] = filter.processSample(mixOscillators(noiseSample));
+
+    // Once per MAX_BLOCK_SIZE samples, the same interval as the block path
+    if (++samplesSinceStabilityCheck >= MAX_BLOCK_SIZE)
     {
-        // Modulate filter resonance
-        float modAmount = lfo1Value * 0.5f;
-        filter.setResonance(std::clamp(baseFilterResonance + modAmount, 0.0f, 1.0f));
+        samplesSinceStabilityCheck = 0;
+
+        if (!filter.checkStability())
+            std::fill(oversampled, oversampled + oversamplingFactor, 0.0f);
     }
-    else if (lfo1Destination == ModPitch)
+
+    decimator.process(oversamplingFactor, oversampled, 1);
+    float filtered = oversampled[0];
+
+    // If envelope has finished (idle), mark voice as free
+    if (!envelope.isActive())
+    {
+        currentMidiNote = -1;
+    }
+
+    // 5-6. Apply envelope and volume modulation (tremolo) if routed
+    float output = filtered * envLevel;
+
+    if (modulation.targets(ModulationMatrix::DestVolume))
+        output *= volumeGain(0);
+
+    outputPeak = std::max(outputPeak, std::abs(output));
+
+    return output;
+}
+
+void Voice::renderBlock(float* output, int numSamples)
+{
+    // Split into chunks that fit the scratch buffers
+    while (numSamples > 0 && isActive())
     {
-        // Modulate pitch (vibrato) - ±1 semitone range
-        float pitchModCents = lfo1Value * 100.0f;  // ±100 cents = ±1 semitone
-        for (int i = 0; i < NUM_OSCILLATORS; ++i)
+        const int chunkSize = std::min(numSamples, MAX_BLOCK_SIZE);
+        renderChunk(output, chunkSize);
+        output += chunkSize;
+        numSamples -= chunkSize;
+    }
+}
+
+void Voice::renderChunk(float* output, int numSamples)
+{
+    // Envelope first: it doesn't depend on the audio, and tells us how many
+    // samples the voice stays alive for in this chunk
+    const int activeSamples = envelope.processBlock(envelopeBuffer.data(), numSamples);
+
+    // 1. LFOs and the modulation buffers they feed
+    if (sharedLFOBuffers[0] != nullptr)
+        std::copy(sharedLFOBuffers[0], sharedLFOBuffers[0] + activeSamples, lfo1Buffer.begin());
+    else
+        lfo1.processBlock(lfo1Buffer.data(), activeSamples);
+
+    if (sharedLFOBuffers[1] != nullptr)
+        std::copy(sharedLFOBuffers[1], sharedLFOBuffers[1] + activeSamples, lfo2Buffer.begin());
+    else
+        lfo2.processBlock(lfo2Buffer.data(), activeSamples);
+
+    if (modulation.isActive())
+        renderModulation(activeSamples);
+
+    // Oscillators, drive and filter run at the oversampled rate
+    const int factor = oversamplingFactor;
+    const int oversampledSamples = activeSamples * factor;
+
+    using M = ModulationMatrix;
+    const bool oscillatorsTargeted = modulation.targetsAny(M::DestPitch, M::DestPWM);
+    const bool filterTargeted = modulation.targetsAny(M::DestFilterCutoff, M::DestFilterRes);
+
+    // Parameters the matrix stopped targeting go back to their base values
+    restoreUnmodulatedParameters(true);
+
+    if (oscillatorsTargeted)
+    {
+        // 2-3. Pitch/pulse width move every sample, so oscillators run sample by sample
+        for (int i = 0; i < activeSamples; ++i)
         {
-            if (oscSettings[i].enabled && currentMidiNote >= 0)
-            {
-                // Calculate base frequency with octave and detune
-                float baseFreq = AudioUtils::midiNoteToFrequency(currentMidiNote);
-                float octaveMultiplier = std::pow(2.0f, static_cast<float>(oscSettings[i].octaveOffset));
-                float totalDetuneCents = oscSettings[i].detuneCents + unisonDetune + pitchModCents;
-                float detuneMultiplier = std::pow(2.0f, totalDetuneCents / 1200.0f);
-                float finalFreq = baseFreq * octaveMultiplier * detuneMultiplier;
-                oscillators[i].setFrequency(finalFreq);
-            }
+            applyOscillatorModulation(i);
+
+            const float noiseSample = noiseEnabled ? noiseGenerator.processSample() : 0.0f;
+
+            for (int j = i * factor; j < (i + 1) * factor; ++j)
+                mixBuffer[static_cast<size_t>(j)] = mixOscillators(noiseSample);
         }
     }
-    else if (lfo1Destination == ModPWM)
+    else
     {
-        // Modulate pulse width - oscillate around 50% (0.25 to 0.75 range)
-        float pwMod = 0.5f + (lfo1Value * 0.25f);  // 0.25 to 0.75
-        for (int i = 0; i < NUM_OSCILLATORS; ++i)
+        // 3. Mix all enabled oscillators + noise, one stage at a time
+        std::fill(mixBuffer.begin(), mixBuffer.begin() + oversampledSamples, 0.0f);
+
+        const auto numMixed = static_cast<size_t>(oversampledSamples);
+
+        for (size_t osc = 0; osc < NUM_OSCILLATORS; ++osc)
         {
-            if (oscSettings[i].enabled)
+            if (!oscSettings[osc].enabled)
+                continue;
+
+            oscillators[osc].processBlock(oscBuffer.data(), oversampledSamples);
+
+            const float gain = oscSettings[osc].gain;
+            const float drive = oscSettings[osc].drive;
+
+            if (drive > 1.01f)  // Small threshold for floating point precision
+            {
+                for (size_t i = 0; i < numMixed; ++i)
+                    mixBuffer[i] += AudioUtils::fastTanh(oscBuffer[i] * drive) * gain;
+            }
+            else
             {
-                oscillators[i].setPulseWidth(std::clamp(pwMod, 0.01f, 0.99f));
+                for (size_t i = 0; i < numMixed; ++i)
+                    mixBuffer[i] += oscBuffer[i] * gain;
             }
         }
+
+        if (noiseEnabled)
+        {
+            // Noise is generated at the host rate (keeps its colour) and held
+            noiseGenerator.processBlock(oscBuffer.data(), activeSamples);
+
+            for (size_t i = 0; i < numMixed; ++i)
+                mixBuffer[i] += oscBuffer[i >> oversamplingShift] * noiseGain;
+        }
+    }
+
+    // 4. Filter the mixed block
+    if (filterTargeted && activeSamples > 0)
+    {
+        // Cutoff/resonance coefficients are computed at the matrix control
+        // points only: jump to the value at the chunk start, then glide from
+        // one control point to the next
+        applyFilterModulation(0, 0);
+        filter.processBlock(mixBuffer.data(), factor);
+
+        for (int previous = 0; previous < activeSamples - 1;)
+        {
+            const int next = std::min(previous + controlInterval, activeSamples - 1);
+            const int length = (next - previous) * factor;
+
+            applyFilterModulation(next, length);
+            filter.processBlock(mixBuffer.data() + (previous + 1) * factor, length);
+            previous = next;
+        }
     }
     else
     {
-        // Reset filter parameters if not being modulated
-        filter.setCutoff(baseFilterCutoff);
-        filter.setResonance(baseFilterResonance);
+        filter.processBlock(mixBuffer.data(), oversampledSamples);
     }
 
-    // --- LFO2 Modulation ---
-    if (lfo2Destination == ModFilterCutoff)
+    // Back to the host rate
+    decimator.process(factor, mixBuffer.data(), activeSamples);
+
+    // 5-6. Envelope and tremolo
+    const auto numOutput = static_cast<size_t>(activeSamples);
+
+    if (modulation.targets(M::DestVolume))
     {
-        float modAmount = lfo2Value * baseFilterCutoff * 2.0f;
-        filter.setCutoff(std::clamp(baseFilterCutoff + modAmount, 20.0f, 12000.0f));
+        for (size_t i = 0; i < numOutput; ++i)
+            mixBuffer[i] = mixBuffer[i] * envelopeBuffer[i] * volumeGain(static_cast<int>(i));
     }
-    else if (lfo2Destination == ModFilterRes)
+    else
     {
-        float modAmount = lfo2Value * 0.5f;
-        filter.setResonance(std::clamp(baseFilterResonance + modAmount, 0.0f, 1.0f));
+        for (size_t i = 0; i < numOutput; ++i)
+            mixBuffer[i] *= envelopeBuffer[i];
     }
-    else if (lfo2Destination == ModPitch)
+
+    // Accumulate into the output, tracking the level for voice sleep
+    float peak = outputPeak;
+
+    for (size_t i = 0; i < numOutput; ++i)
     {
-        // Modulate pitch (vibrato) - ±1 semitone range
-        float pitchModCents = lfo2Value * 100.0f;  // ±100 cents = ±1 semitone
-        for (int i = 0; i < NUM_OSCILLATORS; ++i)
-        {
-            if (oscSettings[i].enabled && currentMidiNote >= 0)
-            {
-                // Calculate base frequency with octave and detune
-                float baseFreq = AudioUtils::midiNoteToFrequency(currentMidiNote);
-                float octaveMultiplier = std::pow(2.0f, static_cast<float>(oscSettings[i].octaveOffset));
-                float totalDetuneCents = oscSettings[i].detuneCents + unisonDetune + pitchModCents;
-                float detuneMultiplier = std::pow(2.0f, totalDetuneCents / 1200.0f);
-                float finalFreq = baseFreq * octaveMultiplier * detuneMultiplier;
-                oscillators[i].setFrequency(finalFreq);
-            }
-        }
+        output[i] += mixBuffer[i];
+        peak = std::max(peak, std::abs(mixBuffer[i]));
     }
-    else if (lfo2Destination == ModPWM)
+
+    outputPeak = peak;
+
+    // If envelope has finished (idle), mark voice as free
+    if (!envelope.isActive())
     {
-        // Modulate pulse width - oscillate around 50% (0.25 to 0.75 range)
-        float pwMod = 0.5f + (lfo2Value * 0.25f);  // 0.25 to 0.75
-        for (int i = 0; i < NUM_OSCILLATORS; ++i)
+        currentMidiNote = -1;
+    }
+}
+
+void Voice::restoreUnmodulatedParameters(bool keepTargeted)
+{
+    using M = ModulationMatrix;
+
+    if (pitchModulated && !(keepTargeted && modulation.targets(M::DestPitch)))
+    {
+        updateOscillatorFrequencies();
+        pitchModulated = false;
+    }
+
+    if (pulseWidthModulated && !(keepTargeted && modulation.targets(M::DestPWM)))
+    {
+        for (size_t i = 0; i < NUM_OSCILLATORS; ++i)
         {
-            if (oscSettings[i].enabled)
-            {
-                oscillators[i].setPulseWidth(std::clamp(pwMod, 0.01f, 0.99f));
-            }
+            oscillators[i].setPulseWidth(oscSettings[i].pulseWidth);
         }
+
+        pulseWidthModulated = false;
     }
-    else if (lfo2Destination != ModVolume && lfo1Destination != ModFilterCutoff && lfo1Destination != ModFilterRes)
+
+    if (filterModulated && !(keepTargeted && modulation.targetsAny(M::DestFilterCutoff, M::DestFilterRes)))
     {
-        // Reset filter parameters if neither LFO is modulating them
         filter.setCutoff(baseFilterCutoff);
         filter.setResonance(baseFilterResonance);
+        filterModulated = false;
     }
+}
 
-    // 3. Mix all enabled oscillators + noise
-    float mix = mixOscillators();
+void Voice::evaluateModulation(float lfo1Value, float lfo2Value, float envelopeLevel, float* destinations) const
+{
+    using M = ModulationMatrix;
 
-    // 4. Apply filter to mixed signal
-    float filtered = filter.processSample(mix);
+    float sources[M::NumSources] = {};
+    sources[M::SourceLFO1] = lfo1Value;
+    sources[M::SourceLFO2] = lfo2Value;
+    sources[M::SourceEnvelope] = envelopeLevel;
+    sources[M::SourceVelocity] = noteVelocity;
+    sources[M::SourceNote] = currentMidiNote >= 0 ? static_cast<float>(currentMidiNote - 60) / 60.0f : 0.0f;
+    sources[M::SourceModWheel] = modWheel;
 
-    // 5. Apply envelope to filtered signal
-    float envLevel = envelope.processSample();
+    modulation.evaluate(sources, destinations);
 
-    // If envelope has finished (idle), mark voice as free
-    if (!envelope.isActive())
+    // Pitch is interpolated as a frequency ratio (1 unit = 1 semitone)
+    destinations[M::DestPitch] = tables->centsToRatio(destinations[M::DestPitch] * 100.0f);
+}
+
+void Voice::renderModulation(int numSamples)
+{
+    constexpr int numDestinations = ModulationMatrix::NumDestinations;
+
+    if (numSamples <= 0)
+        return;
+
+    float previous[numDestinations];
+    evaluateModulation(lfo1Buffer[0], lfo2Buffer[0], envelopeBuffer[0], previous);
+
+    for (int d = 0; d < numDestinations; ++d)
+        modulationBuffers[static_cast<size_t>(d)][0] = previous[d];
+
+    // Control points every controlInterval samples plus the last sample;
+    // linear interpolation in between
+    for (int previousIndex = 0; previousIndex < numSamples - 1;)
     {
-        currentMidiNote = -1;
+        const int index = std::min(previousIndex + controlInterval, numSamples - 1);
+        const auto sample = static_cast<size_t>(index);
+
+        float current[numDestinations];
+        evaluateModulation(lfo1Buffer[sample], lfo2Buffer[sample], envelopeBuffer[sample], current);
+
+        const float scale = 1.0f / static_cast<float>(index - previousIndex);
+
+        for (int d = 1; d < numDestinations; ++d)
+        {
+            if (!modulation.targets(static_cast<ModulationMatrix::Destination>(d)))
+                continue;
+
+            auto& buffer = modulationBuffers[static_cast<size_t>(d)];
+            const float step = (current[d] - previous[d]) * scale;
+
+            for (int i = previousIndex + 1; i < index; ++i)
+                buffer[static_cast<size_t>(i)] = previous[d] + step * static_cast<float>(i - previousIndex);
+
+            buffer[sample] = current[d];
+            previous[d] = current[d];
+        }
+
+        previousIndex = index;
     }
+}
 
-    float output = filtered * envLevel;
+void Voice::applyOscillatorModulation(int index)
+{
+    if (modulation.targets(ModulationMatrix::DestPitch) && currentMidiNote >= 0)
+    {
+        pitchModulated = true;
+
+        // Vibrato: scale the unmodulated frequencies
+        const float ratio = modulationBuffers[ModulationMatrix::DestPitch][static_cast<size_t>(index)];
+
+        for (size_t i = 0; i < NUM_OSCILLATORS; ++i)
+        {
+            if (oscSettings[i].enabled)
+                oscillators[i].setFrequency(oscFrequencies[i] * ratio);
+        }
+    }
 
-    // 6. Apply volume modulation (tremolo) if selected
-    if (lfo1Destination == ModVolume)
+    if (modulation.targets(ModulationMatrix::DestPWM))
     {
-        // Tremolo: oscillate volume between 0.5 and 1.0 (never silent)
-        float volumeMod = 0.75f + (lfo1Value * 0.25f);  // 0.5 to 1.0
-        output *= volumeMod;
+        pulseWidthModulated = true;
+
+        // Modulate pulse width - oscillate around 50% (0.25 to 0.75 per unit)
+        const float pulseWidth = 0.5f + modulationBuffers[ModulationMatrix::DestPWM][static_cast<size_t>(index)] * 0.25f;
+
+        for (size_t i = 0; i < NUM_OSCILLATORS; ++i)
+        {
+            if (oscSettings[i].enabled)
+                oscillators[i].setPulseWidth(std::clamp(pulseWidth, 0.01f, 0.99f));
+        }
     }
-    if (lfo2Destination == ModVolume)
+}
+
+void Voice::applyFilterModulation(int index, int rampSamples)
+{
+    filterModulated = true;
+
+    // Unmodulated parameters stay at their base values
+    float cutoff = baseFilterCutoff;
+    float resonance = baseFilterResonance;
+
+    if (modulation.targets(ModulationMatrix::DestFilterCutoff))
     {
-        // Tremolo: oscillate volume between 0.5 and 1.0 (never silent)
-        float volumeMod = 0.75f + (lfo2Value * 0.25f);  // 0.5 to 1.0
-        output *= volumeMod;
+        // Modulate filter cutoff (±2x base cutoff per unit)
+        float modAmount = modulationBuffers[ModulationMatrix::DestFilterCutoff][static_cast<size_t>(index)] * baseFilterCutoff * 2.0f;
+        cutoff = std::clamp(baseFilterCutoff + modAmount, 20.0f, 12000.0f);
     }
 
-    return output;
+    if (modulation.targets(ModulationMatrix::DestFilterRes))
+    {
+        // Modulate filter resonance (±0.5 per unit)
+        float modAmount = modulationBuffers[ModulationMatrix::DestFilterRes][static_cast<size_t>(index)] * 0.5f;
+        resonance = std::clamp(baseFilterResonance + modAmount, 0.0f, 1.0f);
+    }
+
+    if (rampSamples > 0)
+    {
+        filter.rampTo(cutoff, resonance, rampSamples);
+    }
+    else
+    {
+        filter.setCutoff(cutoff);
+        filter.setResonance(resonance);
+    }
+}
+
+float Voice::volumeGain(int index) const
+{
+    // Tremolo: 0.75 ± 0.25 per unit (0.5 to 1.0 for a full-depth LFO, never inverted)
+    return std::max(0.0f, 0.75f + modulationBuffers[ModulationMatrix::DestVolume][static_cast<size_t>(index)] * 0.25f);
 }
 
-float Voice::mixOscillators()
+float Voice::mixOscillators(float noiseSample)
 {
     float sum = 0.0f;
 
     // Mix all enabled oscillators with their individual gains
-    for (int i = 0; i < NUM_OSCILLATORS; ++i)
+    for (size_t i = 0; i < NUM_OSCILLATORS; ++i)
     {
         if (oscSettings[i].enabled)
         {
@@ -434,7 +751,7 @@ float Voice::mixOscillators()
             {
                 // Soft saturation: tanh adds warm harmonics and compression
                 // Volume drops slightly at high drive (expected behavior)
-                oscSample = std::tanh(oscSample * oscSettings[i].drive);
+                oscSample = AudioUtils::fastTanh(oscSample * oscSettings[i].drive);
             }
 
             sum += oscSample * oscSettings[i].gain;
@@ -444,7 +761,6 @@ float Voice::mixOscillators()
     // Mix noise if enabled (like a 4th oscillator)
     if (noiseEnabled)
     {
-        float noiseSample = noiseGenerator.processSample();
         sum += noiseSample * noiseGain;
     }
 
@@ -461,23 +777,20 @@ void Voice::updateOscillatorFrequencies()
         return;
 
     // Calculate base frequency from MIDI note
-    float baseFreq = AudioUtils::midiNoteToFrequency(currentMidiNote);
+    float baseFreq = tables->noteToFrequency(currentMidiNote);
 
     // Update each oscillator with its own octave offset and detune
-    for (int i = 0; i < NUM_OSCILLATORS; ++i)
+    for (size_t i = 0; i < NUM_OSCILLATORS; ++i)
     {
-        // Apply octave offset (multiply by 2^octave)
-        // -3 octaves = ×1/8, +3 octaves = ×8
-        float octaveMultiplier = std::pow(2.0f, static_cast<float>(oscSettings[i].octaveOffset));
-
-        // Apply oscillator detune + unison detune (in cents)
-        // 1200 cents = 1 octave
-        float totalDetuneCents = oscSettings[i].detuneCents + unisonDetune;
-        float detuneMultiplier = std::pow(2.0f, totalDetuneCents / 1200.0f);
+        // Octave offset + oscillator detune + unison detune, all in cents
+        // 1200 cents = 1 octave (-3 octaves = ×1/8, +3 octaves = ×8)
+        float totalDetuneCents = static_cast<float>(oscSettings[i].octaveOffset) * 1200.0f
+                                 + oscSettings[i].detuneCents + unisonDetune;
 
         // Calculate final frequency
-        float finalFreq = baseFreq * octaveMultiplier * detuneMultiplier;
+        float finalFreq = baseFreq * tables->centsToRatio(totalDetuneCents);
 
+        oscFrequencies[i] = finalFreq;
         oscillators[i].setFrequency(finalFreq);
     }
 }
@@ -492,6 +805,31 @@ bool Voice::isActive() const
     return envelope.isActive();
 }
 
+bool Voice::sleepIfSilent(float threshold, int numSamples, int holdSamples)
+{
+    const float peak = outputPeak;
+    outputPeak = 0.0f;
+
+    const auto phase = envelope.getCurrentPhase();
+    const bool fading = phase == Envelope::Phase::Release
+                     || (phase != Envelope::Phase::Attack && envelope.getCurrentLevel() < threshold);
+
+    if (!fading || peak >= threshold)
+    {
+        silentSamples = 0;
+        return false;
+    }
+
+    silentSamples += numSamples;
+
+    if (silentSamples < holdSamples)
+        return false;
+
+    // Inaudible: stop now instead of running out the release
+    reset();
+    return true;
+}
+
 bool Voice::isSounding() const
 {
     // Voice is producing audible output if envelope is active and not in release
@@ -5,7 +5,10 @@
 #include "Envelope.h"
 #include "MoogFilter.h"
 #include "LFO.h"
+#include "ModulationMatrix.h"
+#include "Oversampling.h"
 #include <array>
+#include <cstdint>
 
 /**
  * Voice - Single synthesizer voice with triple oscillator architecture
@@ -27,6 +30,8 @@ class Voice
 {
 public:
     static constexpr int NUM_OSCILLATORS = 3;
+    static constexpr int MAX_BLOCK_SIZE = 64;  // Internal sub-block length for renderBlock
+    static constexpr int DEFAULT_CONTROL_INTERVAL = 16;  // Samples between modulation matrix evaluations
 
     Voice();
 
@@ -36,6 +41,14 @@ public:
      */
     void setSampleRate(double sampleRate);
 
+    /**
+     * Run oscillators, drive and filter at a multiple of the sample rate
+     * LFOs and envelope stay at the host rate. Resets the decimator state.
+     * @param factor 1 (off), 2 or 4
+     */
+    void setOversampling(int factor);
+    int getOversampling() const { return oversamplingFactor; }
+
     /**
      * Voice lifecycle
      */
@@ -43,6 +56,12 @@ public:
     void noteOff();
     void reset();
 
+    /**
+     * Seed the voice's random sources (noise, unison phases, sample & hold LFOs)
+     * Voices of one instance need different seeds so their noise is uncorrelated
+     */
+    void setRandomSeed(uint32_t seed);
+
     /**
      * Per-oscillator parameter updates
      */
@@ -53,6 +72,7 @@ public:
     void setOscillatorOctave(int oscIndex, int octaveOffset);  // -3 to +3
     void setOscillatorPulseWidth(int oscIndex, float pw);      // 0.01 to 0.99
     void setOscillatorDrive(int oscIndex, float drive);        // 1.0 to 10.0 (saturation)
+    void setOscillatorEngine(int oscIndex, Oscillator::Engine engine);  // PolyBLEP or Wavetable
 
     /**
      * Noise generator parameters
@@ -70,6 +90,7 @@ public:
      * Filter parameters
      */
     void setFilterMode(MoogFilter::Mode mode);
+    void setFilterModel(MoogFilter::Model model);
     void setFilterCutoff(float cutoffHz);      // 20.0 - 12000.0 Hz
     void setFilterResonance(float resonance);  // 0.0 - 1.0
 
@@ -91,6 +112,23 @@ public:
     void setLFO2RateMode(LFO::RateMode mode);    // Free or Sync
     void setLFO2SyncDivision(LFO::SyncDivision division);  // 1/16, 1/8, 1/4, etc.
     void setLFO2BPM(float bpm);                  // For MIDI sync
+    void setLFOTransportPosition(double ppqPosition);  // Locks tempo-synced LFOs to the host position
+
+    /**
+     * Read LFO values from a buffer shared by several voices instead of running this voice's LFO
+     * @param lfoIndex 0 = LFO 1, 1 = LFO 2
+     * @param buffer Values for the next processSample() call or renderBlock() call of at most
+     *               MAX_BLOCK_SIZE samples (refilled by the owner before each call); nullptr = own LFO
+     */
+    void setSharedLFOBuffer(int lfoIndex, const float* buffer);
+
+    /**
+     * Modulation matrix
+     */
+    void setModulationSlot(int userSlot, ModulationMatrix::Source source,
+                           ModulationMatrix::Destination destination, float amount);  // amount -1.0 to 1.0
+    void setModWheel(float value);               // 0.0 - 1.0
+    void setControlInterval(int numSamples);     // 1 - MAX_BLOCK_SIZE samples between matrix evaluations
 
     /**
      * Audio generation
@@ -98,31 +136,43 @@ public:
      */
     float processSample();
 
+    /**
+     * Block audio generation
+     * Adds this voice's output to the buffer (caller is responsible for clearing it)
+     * @param output Buffer to accumulate into
+     * @param numSamples Number of samples to render (split into MAX_BLOCK_SIZE chunks internally)
+     */
+    void renderBlock(float* output, int numSamples);
+
     /**
      * Voice state queries
      */
     bool isActive() const;          // Has active note (envelope not idle)
     bool isSounding() const;        // Producing audible output (not in release)
     int getCurrentNote() const { return currentMidiNote; }
-    int getAge() const { return age; }
+    uint64_t getStartOrder() const { return startOrder; }
+    int getFilterInstabilityResets() const { return filter.getInstabilityResets(); }
 
     /**
-     * Age management for voice stealing (LRU algorithm)
+     * Voice sleep: stop the voice once its output has stayed below threshold
+     * (linear peak) for holdSamples. Only released voices and held voices
+     * whose envelope level is below the threshold (past the attack, e.g. a
+     * sustain-0 patch) can sleep. A held note with an audible envelope never
+     * sleeps, even while its output is silent (e.g. a filter sweep).
+     * Call after each rendered block.
+     * @param numSamples Samples rendered since the last call
+     * @return True if the voice was stopped
      */
-    void incrementAge() { ++age; }
-    void resetAge() { age = 0; }
+    bool sleepIfSilent(float threshold, int numSamples, int holdSamples);
+
+    /**
+     * Allocation stamp for voice stealing (LRU: the lowest stamp is the oldest note)
+     * Set by the voice manager from a counter that increases with every note-on
+     */
+    void setStartOrder(uint64_t order) { startOrder = order; }
 
 private:
-    // LFO modulation destinations
-    enum ModDestination
-    {
-        ModNone = 0,
-        ModFilterCutoff,
-        ModPitch,        // Vibrato (all oscillators)
-        ModPWM,          // Modulate pulse width
-        ModFilterRes,    // Filter resonance
-        ModVolume        // Tremolo (amplitude modulation)
-    };
+    friend class VoiceLanes;  // Renders groups of voices lane-parallel using this voice's state
 
     // Oscillator settings (per-oscillator parameters)
     struct OscillatorSettings
@@ -132,34 +182,73 @@ private:
         float detuneCents = 0.0f;        // ±100 cents
         int octaveOffset = 0;            // -3 to +3 octaves
         float drive = 1.0f;              // 1.0 - 10.0 (1.0 = no saturation)
+        float pulseWidth = 0.5f;         // Unmodulated pulse width
     };
 
     // DSP components
     std::array<Oscillator, NUM_OSCILLATORS> oscillators;
     NoiseGenerator noiseGenerator;
+    FastRandom random;       // Unison start phases
     MoogFilter filter;       // Applied after mixing, before envelope
     Envelope envelope;
     LFO lfo1;
     LFO lfo2;
 
+    std::shared_ptr<const LookupTables> tables;  // Note and cents tables
+
     // Per-oscillator settings
     std::array<OscillatorSettings, NUM_OSCILLATORS> oscSettings;
+    std::array<float, NUM_OSCILLATORS> oscFrequencies {};  // Unmodulated frequency (Hz) per oscillator
 
     // Noise settings
     bool noiseEnabled = false;
     float noiseGain = 0.0f;
 
-    // LFO settings
-    ModDestination lfo1Destination = ModNone;
-    ModDestination lfo2Destination = ModNone;
+    // Global LFO values (nullptr = this voice's own LFO)
+    std::array<const float*, 2> sharedLFOBuffers {};
+
+    // Modulation (LFO destinations are matrix slots 0 and 1)
+    ModulationMatrix modulation;
+    int controlInterval = DEFAULT_CONTROL_INTERVAL;
+    float noteVelocity = 0.0f;            // Velocity source
+    float modWheel = 0.0f;                // Mod wheel source
     float baseFilterCutoff = 1000.0f;     // Unmodulated filter cutoff
     float baseFilterResonance = 0.0f;     // Unmodulated filter resonance
+    bool pitchModulated = false;          // Modulation has moved these parameters off their base values
+    bool pulseWidthModulated = false;
+    bool filterModulated = false;
+
+    // Oversampling
+    double sampleRate = 44100.0;          // Host rate (LFOs, envelope)
+    int oversamplingFactor = 1;
+    int oversamplingShift = 0;            // log2(oversamplingFactor)
+    Oversampling::Decimator<float> decimator;
+
+    // Scratch buffers for block rendering (one internal chunk each; oscillator
+    // and mix buffers hold the chunk at the oversampled rate)
+    static constexpr int MAX_OVERSAMPLED_BLOCK_SIZE = MAX_BLOCK_SIZE * Oversampling::MAX_FACTOR;
+
+    std::array<float, MAX_BLOCK_SIZE> lfo1Buffer {};
+    std::array<float, MAX_BLOCK_SIZE> lfo2Buffer {};
+    std::array<float, MAX_OVERSAMPLED_BLOCK_SIZE> oscBuffer {};
+    std::array<float, MAX_OVERSAMPLED_BLOCK_SIZE> mixBuffer {};
+    std::array<float, MAX_BLOCK_SIZE> envelopeBuffer {};
+
+    // Per-sample modulation per destination (pitch holds the frequency ratio)
+    std::array<std::array<float, MAX_BLOCK_SIZE>, ModulationMatrix::NumDestinations> modulationBuffers {};
 
     // Voice state
     int currentMidiNote = -1;   // -1 = voice is free
-    int age = 0;                // Increments each audio callback (for LRU stealing)
+    uint64_t startOrder = 0;    // Allocation stamp of the current note (for LRU stealing)
     float unisonDetune = 0.0f;  // Detuning in cents for unison mode
 
+    // processSample() checks the filter once per MAX_BLOCK_SIZE samples, like renderBlock()
+    int samplesSinceStabilityCheck = 0;
+
+    // Output level tracking for voice sleep
+    float outputPeak = 0.0f;    // Peak since the last sleepIfSilent() call
+    int silentSamples = 0;      // Consecutive samples below the sleep threshold
+
     /**
      * Update all oscillator frequencies based on MIDI note, octave, detune, and unison detune
      */
@@ -167,7 +256,41 @@ private:
 
     /**
      * Mix all enabled oscillators + noise
+     * @param noiseSample Noise for the current host-rate sample (held across oversampled ones)
      * @return Mixed signal (before envelope)
      */
-    float mixOscillators();
+    float mixOscillators(float noiseSample);
+
+    /**
+     * Evaluate the modulation matrix for one set of source values
+     * @param destinations Receives one value per destination (pitch as a frequency ratio)
+     */
+    void evaluateModulation(float lfo1Value, float lfo2Value, float envelopeLevel, float* destinations) const;
+
+    /**
+     * Fill modulationBuffers for a chunk: the matrix is evaluated every
+     * controlInterval samples and linearly interpolated in between
+     */
+    void renderModulation(int numSamples);
+
+    /**
+     * Apply modulationBuffers[...][index] to oscillators (pitch, PWM) and filter
+     * @param rampSamples Glide the filter coefficients to the modulated values
+     *                    over this many (oversampled) samples; 0 = jump
+     */
+    void applyOscillatorModulation(int index);
+    void applyFilterModulation(int index, int rampSamples);
+    float volumeGain(int index) const;
+
+    /**
+     * Put parameters modulation has moved back to their unmodulated values
+     * Each group is restored once, not on every chunk.
+     * @param keepTargeted Leave the ones the matrix still targets (they are applied again right after)
+     */
+    void restoreUnmodulatedParameters(bool keepTargeted);
+
+    /**
+     * Render up to MAX_BLOCK_SIZE samples and add them to output
+     */
+    void renderChunk(float* output, int numSamples);
 };
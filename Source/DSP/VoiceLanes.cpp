@@ -0,0 +1,851 @@
+#include "VoiceLanes.h"
+#include "AudioUtils.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace SIMDOps;
+
+namespace
+{
+    // Envelope phases as lane values (Envelope::Phase order)
+    constexpr float EnvIdle = 0.0f;
+    constexpr float EnvAttack = 1.0f;
+    constexpr float EnvDecay = 2.0f;
+    constexpr float EnvSustain = 3.0f;
+    constexpr float EnvRelease = 4.0f;
+
+    /**
+     * PolyBLEP correction per lane (see AudioUtils::polyBLEP)
+     */
+    inline FloatVec polyBLEP(FloatVec t, FloatVec dt, FloatVec invDt)
+    {
+        const FloatVec one = FloatVec::broadcast(1.0f);
+
+        // Discontinuity at t=0: 2x - x^2 - 1
+        const FloatVec a = t * invDt;
+        const FloatVec rising = a + a - a * a - one;
+
+        // Discontinuity at t=1: x^2 + 2x + 1
+        const FloatVec b = (t - one) * invDt;
+        const FloatVec falling = b * b + b + b + one;
+
+        return select(t < dt, rising, select(t > one - dt, falling, FloatVec::broadcast(0.0f)));
+    }
+
+    /**
+     * Wavetable engine, one table read per lane (mip level follows each lane's increment)
+     */
+    FloatVec wavetableSample(const Wavetable& wavetable, Oscillator::Waveform waveform,
+                             FloatVec phase, FloatVec increment, FloatVec pulseWidth)
+    {
+        float phases[FloatVec::size], increments[FloatVec::size], widths[FloatVec::size], samples[FloatVec::size];
+
+        phase.store(phases);
+        increment.store(increments);
+        pulseWidth.store(widths);
+
+        for (int lane = 0; lane < FloatVec::size; ++lane)
+        {
+            samples[lane] = Oscillator::wavetableSample(wavetable, waveform,
+                                                        Wavetable::levelForIncrement(increments[lane]),
+                                                        phases[lane], widths[lane]);
+        }
+
+        return FloatVec::load(samples);
+    }
+
+    inline FloatVec wrap(FloatVec phase)
+    {
+        const FloatVec one = FloatVec::broadcast(1.0f);
+        return select(phase >= one, phase - one, phase);
+    }
+
+    /**
+     * Pack one float per voice into a lane vector (unused lanes get fallback)
+     */
+    template <typename Getter>
+    FloatVec gather(Voice* const* voices, int numVoices, float fallback, Getter get)
+    {
+        float values[VoiceLanes::LANES];
+
+        for (int lane = 0; lane < VoiceLanes::LANES; ++lane)
+            values[lane] = lane < numVoices ? get(*voices[lane]) : fallback;
+
+        return FloatVec::load(values);
+    }
+
+    template <typename Setter>
+    void scatter(Voice* const* voices, int numVoices, FloatVec vec, Setter set)
+    {
+        float values[VoiceLanes::LANES];
+        vec.store(values);
+
+        for (int lane = 0; lane < numVoices; ++lane)
+            set(*voices[lane], values[lane]);
+    }
+}
+
+void VoiceLanes::render(Voice* const* voices, int numVoices, float* output, int numSamples)
+{
+    for (int first = 0; first < numVoices; first += LANES)
+    {
+        loadGroup(voices + first, std::min(LANES, numVoices - first));
+
+        for (int offset = 0; offset < numSamples; offset += BLOCK_SIZE)
+        {
+            renderChunk(output + offset, std::min(BLOCK_SIZE, numSamples - offset));
+        }
+
+        storeGroup();
+    }
+}
+
+//==============================================================================
+// State transfer
+//==============================================================================
+
+void VoiceLanes::loadGroup(Voice* const* voices, int numVoices)
+{
+    group.numVoices = numVoices;
+
+    for (int lane = 0; lane < LANES; ++lane)
+    {
+        group.voices[lane] = lane < numVoices ? voices[lane] : nullptr;
+
+        if (lane < numVoices)
+        {
+            Voice& voice = *voices[lane];
+
+            // Lanes always start from unmodulated parameters
+            voice.restoreUnmodulatedParameters(false);
+
+            if (voice.filter.coefficientsNeedUpdate)
+                voice.filter.updateCoefficients();
+        }
+    }
+
+    const auto& v = group.voices;
+    const int n = numVoices;
+
+    for (size_t i = 0; i < NUM_OSCILLATORS; ++i)
+    {
+        group.oscPhase[i] = gather(v, n, 0.0f, [i](Voice& x) { return static_cast<float>(x.oscillators[i].phase); });
+        group.oscPhaseError[i] = Vec::broadcast(0.0f);
+        group.oscIncrement[i] = gather(v, n, 0.01f, [i](Voice& x) { return static_cast<float>(x.oscillators[i].phaseIncrement); });
+        group.oscFrequency[i] = gather(v, n, 440.0f, [i](Voice& x) { return x.oscFrequencies[i]; });
+    }
+
+    group.stage1 = gather(v, n, 0.0f, [](Voice& x) { return x.filter.stage1; });
+    group.stage2 = gather(v, n, 0.0f, [](Voice& x) { return x.filter.stage2; });
+    group.stage3 = gather(v, n, 0.0f, [](Voice& x) { return x.filter.stage3; });
+    group.stage4 = gather(v, n, 0.0f, [](Voice& x) { return x.filter.stage4; });
+    group.g = gather(v, n, 0.0f, [](Voice& x) { return x.filter.g; });
+    group.feedbackGain = gather(v, n, 0.0f, [](Voice& x) { return x.filter.feedbackGain; });
+    group.outputGain = gather(v, n, 1.0f, [](Voice& x) { return x.filter.outputGain; });
+
+    group.oversamplingFactor = group.voices[0]->oversamplingFactor;
+    group.oversamplingShift = group.voices[0]->oversamplingShift;
+
+    if (group.oversamplingFactor > 1)
+    {
+        for (size_t k = 0; k < Oversampling::STEEP_ORDER; ++k)
+        {
+            group.decimator.steep.x[k] = gather(v, n, 0.0f, [k](Voice& x) { return x.decimator.steep.x[k]; });
+            group.decimator.steep.y[k] = gather(v, n, 0.0f, [k](Voice& x) { return x.decimator.steep.y[k]; });
+        }
+
+        for (size_t k = 0; k < Oversampling::WIDE_ORDER; ++k)
+        {
+            group.decimator.wide.x[k] = gather(v, n, 0.0f, [k](Voice& x) { return x.decimator.wide.x[k]; });
+            group.decimator.wide.y[k] = gather(v, n, 0.0f, [k](Voice& x) { return x.decimator.wide.y[k]; });
+        }
+    }
+
+    group.envLevel = gather(v, n, 0.0f, [](Voice& x) { return x.envelope.currentLevel; });
+    group.envPhase = gather(v, n, EnvIdle, [](Voice& x) { return static_cast<float>(x.envelope.currentPhase); });
+    group.envVelocity = gather(v, n, 0.0f, [](Voice& x) { return x.envelope.velocity; });
+    group.envReleaseRate = gather(v, n, 0.0f, [](Voice& x) { return x.envelope.releaseRate; });
+
+    for (int l = 0; l < 2; ++l)
+    {
+        auto lfoOf = [l](Voice& x) -> LFO& { return l == 0 ? x.lfo1 : x.lfo2; };
+        group.lfoPhase[l] = gather(v, n, 0.0f, [&](Voice& x) { return lfoOf(x).phase; });
+        group.lfoLastPhase[l] = gather(v, n, 0.0f, [&](Voice& x) { return lfoOf(x).lastPhase; });
+        group.lfoIncrement[l] = gather(v, n, 0.0f, [&](Voice& x) { return lfoOf(x).phaseIncrement; });
+        group.lfoHold[l] = gather(v, n, 0.0f, [&](Voice& x) { return lfoOf(x).sampleAndHoldValue; });
+    }
+
+    group.noteVelocity = gather(v, n, 0.0f, [](Voice& x) { return x.noteVelocity; });
+    group.noteOffset = gather(v, n, 0.0f, [](Voice& x)
+    {
+        return x.currentMidiNote >= 0 ? static_cast<float>(x.currentMidiNote - 60) / 60.0f : 0.0f;
+    });
+
+    group.outputPeak = Vec::broadcast(0.0f);
+}
+
+void VoiceLanes::storeGroup()
+{
+    const auto& v = group.voices;
+    const int n = group.numVoices;
+
+    for (size_t i = 0; i < NUM_OSCILLATORS; ++i)
+    {
+        // Fold the accumulated rounding error back into the voices' double phases
+        float phases[LANES], errors[LANES];
+        group.oscPhase[i].store(phases);
+        group.oscPhaseError[i].store(errors);
+
+        for (int lane = 0; lane < n; ++lane)
+        {
+            double phase = static_cast<double>(phases[lane]) - errors[lane];
+            AudioUtils::wrapPhase(phase);
+            v[lane]->oscillators[i].phase = phase;
+        }
+    }
+
+    scatter(v, n, group.stage1, [](Voice& x, float value) { x.filter.stage1 = value; });
+    scatter(v, n, group.stage2, [](Voice& x, float value) { x.filter.stage2 = value; });
+    scatter(v, n, group.stage3, [](Voice& x, float value) { x.filter.stage3 = value; });
+    scatter(v, n, group.stage4, [](Voice& x, float value) { x.filter.stage4 = value; });
+
+    if (group.oversamplingFactor > 1)
+    {
+        for (size_t k = 0; k < Oversampling::STEEP_ORDER; ++k)
+        {
+            scatter(v, n, group.decimator.steep.x[k], [k](Voice& x, float value) { x.decimator.steep.x[k] = value; });
+            scatter(v, n, group.decimator.steep.y[k], [k](Voice& x, float value) { x.decimator.steep.y[k] = value; });
+        }
+
+        for (size_t k = 0; k < Oversampling::WIDE_ORDER; ++k)
+        {
+            scatter(v, n, group.decimator.wide.x[k], [k](Voice& x, float value) { x.decimator.wide.x[k] = value; });
+            scatter(v, n, group.decimator.wide.y[k], [k](Voice& x, float value) { x.decimator.wide.y[k] = value; });
+        }
+    }
+
+    scatter(v, n, group.envLevel, [](Voice& x, float value) { x.envelope.currentLevel = value; });
+    scatter(v, n, group.envPhase, [](Voice& x, float value)
+    {
+        x.envelope.currentPhase = static_cast<Envelope::Phase>(static_cast<int>(value));
+
+        // If envelope has finished (idle), mark voice as free
+        if (!x.envelope.isActive())
+            x.currentMidiNote = -1;
+    });
+
+    for (int l = 0; l < 2; ++l)
+    {
+        auto lfoOf = [l](Voice& x) -> LFO& { return l == 0 ? x.lfo1 : x.lfo2; };
+        scatter(v, n, group.lfoPhase[l], [&](Voice& x, float value) { lfoOf(x).phase = value; });
+        scatter(v, n, group.lfoLastPhase[l], [&](Voice& x, float value) { lfoOf(x).lastPhase = value; });
+        scatter(v, n, group.lfoHold[l], [&](Voice& x, float value) { lfoOf(x).sampleAndHoldValue = value; });
+    }
+
+    scatter(v, n, group.outputPeak, [](Voice& x, float value) { x.outputPeak = std::max(x.outputPeak, value); });
+}
+
+//==============================================================================
+// Rendering
+//==============================================================================
+
+void VoiceLanes::renderChunk(float* output, int numSamples)
+{
+    const Voice& patch = *group.voices[0];
+
+    // Same signal chain as Voice::renderChunk, one stage at a time across all lanes
+    renderLFO(0, numSamples);
+    renderLFO(1, numSamples);
+    renderEnvelope(numSamples);
+
+    if (patch.modulation.isActive())
+        renderModulation(numSamples);
+
+    renderOscillators(numSamples);
+
+    if (patch.noiseEnabled)
+        renderNoise(numSamples);
+
+    renderFilter(numSamples);
+
+    // Back to the host rate
+    group.decimator.process(group.oversamplingFactor, mixBuffer, numSamples);
+
+    // Envelope, tremolo (see Voice::volumeGain) and sum the lanes into the output
+    const Vec* tremolo = patch.modulation.targets(ModulationMatrix::DestVolume)
+                             ? modulationBuffer[ModulationMatrix::DestVolume] : nullptr;
+    const Vec tremoloCenter = Vec::broadcast(0.75f);
+    const Vec tremoloDepth = Vec::broadcast(0.25f);
+    const Vec zero = Vec::broadcast(0.0f);
+    Vec peak = group.outputPeak;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        Vec sample = mixBuffer[i] * envelopeBuffer[i];
+
+        if (tremolo)
+            sample = sample * max(tremoloCenter + tremolo[i] * tremoloDepth, zero);
+
+        peak = max(peak, max(sample, zero - sample));
+        output[i] += sum(sample);
+    }
+
+    group.outputPeak = peak;
+}
+
+void VoiceLanes::renderLFO(int lfoIndex, int numSamples)
+{
+    const Voice& patch = *group.voices[0];
+    const LFO& lfo = lfoIndex == 0 ? patch.lfo1 : patch.lfo2;
+    Vec* out = lfoBuffer[lfoIndex];
+
+    // Global LFO: the same value in every lane
+    if (const float* shared = patch.sharedLFOBuffers[static_cast<size_t>(lfoIndex)])
+    {
+        for (int i = 0; i < numSamples; ++i)
+            out[i] = Vec::broadcast(shared[i]);
+
+        return;
+    }
+
+    Vec phase = group.lfoPhase[lfoIndex];
+    Vec lastPhase = group.lfoLastPhase[lfoIndex];
+    Vec hold = group.lfoHold[lfoIndex];
+    const Vec increment = group.lfoIncrement[lfoIndex];
+    const Vec depth = Vec::broadcast(lfo.depth);
+
+    const Vec one = Vec::broadcast(1.0f);
+    const Vec half = Vec::broadcast(0.5f);
+    const Vec four = Vec::broadcast(4.0f);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        Vec value;
+
+        switch (lfo.waveform)
+        {
+            case LFO::Sine:
+                value = sinCycle(phase);
+                break;
+            case LFO::Triangle:
+                value = select(phase < half, phase * four - one, one - (phase - half) * four);
+                break;
+            case LFO::Square:
+                value = select(phase < half, one, Vec::broadcast(-1.0f));
+                break;
+            case LFO::Sawtooth:
+                value = phase + phase - one;
+                break;
+            case LFO::SampleAndHold:
+            default:
+            {
+                // New random value on lanes whose phase wrapped last sample
+                const auto wrapped = phase < lastPhase;
+
+                if (anyOf(wrapped))
+                {
+                    float held[LANES];
+                    hold.store(held);
+
+                    for (int lane = 0; lane < group.numVoices; ++lane)
+                    {
+                        if (laneOf(wrapped, lane))
+                        {
+                            LFO& laneLfo = lfoIndex == 0 ? group.voices[lane]->lfo1 : group.voices[lane]->lfo2;
+                            held[lane] = laneLfo.random.nextBipolar();
+                        }
+                    }
+
+                    hold = Vec::load(held);
+                }
+
+                value = hold;
+                break;
+            }
+        }
+
+        out[i] = value * depth;
+
+        lastPhase = phase;
+        phase = wrap(phase + increment);
+    }
+
+    group.lfoPhase[lfoIndex] = phase;
+    group.lfoLastPhase[lfoIndex] = lastPhase;
+    group.lfoHold[lfoIndex] = hold;
+}
+
+void VoiceLanes::renderEnvelope(int numSamples)
+{
+    const Envelope& patch = group.voices[0]->envelope;
+
+    const Vec idle = Vec::broadcast(EnvIdle);
+    const Vec attack = Vec::broadcast(EnvAttack);
+    const Vec decay = Vec::broadcast(EnvDecay);
+    const Vec sustain = Vec::broadcast(EnvSustain);
+    const Vec release = Vec::broadcast(EnvRelease);
+
+    const Vec zero = Vec::broadcast(0.0f);
+    const Vec one = Vec::broadcast(1.0f);
+    const Vec attackRate = Vec::broadcast(patch.attackRate);
+    const Vec decayRate = Vec::broadcast(patch.decayRate);
+    const Vec sustainLevel = Vec::broadcast(patch.sustainLevel);
+    const Vec releaseRate = group.envReleaseRate;
+    const Vec velocity = group.envVelocity;
+
+    Vec level = group.envLevel;
+    Vec phase = group.envPhase;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        // Masks from the phase at the start of the sample (one transition per sample, like Envelope)
+        const auto inAttack = phase == attack;
+        const auto inDecay = phase == decay;
+        const auto inSustain = phase == sustain;
+        const auto inRelease = phase == release;
+
+        level = level + select(inAttack, attackRate, zero)
+                      - select(inDecay, decayRate, zero)
+                      - select(inRelease, releaseRate, zero);
+
+        const auto attackDone = inAttack & (level >= one);
+        level = select(attackDone, one, level);
+        phase = select(attackDone, decay, phase);
+
+        const auto decayDone = inDecay & (level <= sustainLevel);
+        level = select(decayDone | inSustain, sustainLevel, level);
+        phase = select(decayDone, sustain, phase);
+
+        const auto releaseDone = inRelease & (level <= zero);
+        level = select(releaseDone, zero, level);
+        phase = select(releaseDone, idle, phase);
+
+        envelopeBuffer[i] = level * velocity;
+    }
+
+    group.envLevel = level;
+    group.envPhase = phase;
+}
+
+void VoiceLanes::renderModulation(int numSamples)
+{
+    using M = ModulationMatrix;
+
+    const Voice& patch = *group.voices[0];
+    const M& matrix = patch.modulation;
+    const M::Slot* slots = matrix.getActiveSlots();
+    const int numSlots = matrix.getNumActiveSlots();
+    const Vec zero = Vec::broadcast(0.0f);
+
+    // Same as Voice::evaluateModulation, one lane per voice
+    auto evaluateAt = [&](int index, Vec* destinations)
+    {
+        Vec sources[M::NumSources];
+        sources[M::SourceNone] = zero;
+        sources[M::SourceLFO1] = lfoBuffer[0][index];
+        sources[M::SourceLFO2] = lfoBuffer[1][index];
+        sources[M::SourceEnvelope] = envelopeBuffer[index];
+        sources[M::SourceVelocity] = group.noteVelocity;
+        sources[M::SourceNote] = group.noteOffset;
+        sources[M::SourceModWheel] = Vec::broadcast(patch.modWheel);
+
+        for (int d = 0; d < M::NumDestinations; ++d)
+            destinations[d] = zero;
+
+        for (int s = 0; s < numSlots; ++s)
+            destinations[slots[s].destination] = destinations[slots[s].destination]
+                                                 + sources[slots[s].source] * Vec::broadcast(slots[s].amount);
+
+        if (matrix.targets(M::DestPitch))
+        {
+            float ratios[LANES];
+            (destinations[M::DestPitch] * Vec::broadcast(100.0f)).store(ratios);
+
+            for (float& ratio : ratios)
+                ratio = patch.tables->centsToRatio(ratio);
+
+            destinations[M::DestPitch] = Vec::load(ratios);
+        }
+    };
+
+    if (numSamples <= 0)
+        return;
+
+    Vec previous[M::NumDestinations];
+    evaluateAt(0, previous);
+
+    for (int d = 0; d < M::NumDestinations; ++d)
+        modulationBuffer[d][0] = previous[d];
+
+    // Control points every controlInterval samples plus the last sample
+    for (int previousIndex = 0; previousIndex < numSamples - 1;)
+    {
+        const int index = std::min(previousIndex + patch.controlInterval, numSamples - 1);
+
+        Vec current[M::NumDestinations];
+        evaluateAt(index, current);
+
+        const Vec scale = Vec::broadcast(1.0f / static_cast<float>(index - previousIndex));
+
+        for (int d = 1; d < M::NumDestinations; ++d)
+        {
+            if (!matrix.targets(static_cast<M::Destination>(d)))
+                continue;
+
+            const Vec step = (current[d] - previous[d]) * scale;
+
+            for (int i = previousIndex + 1; i < index; ++i)
+                modulationBuffer[d][i] = previous[d] + step * Vec::broadcast(static_cast<float>(i - previousIndex));
+
+            modulationBuffer[d][index] = current[d];
+            previous[d] = current[d];
+        }
+
+        previousIndex = index;
+    }
+}
+
+void VoiceLanes::renderOscillators(int numSamples)
+{
+    const Voice& patch = *group.voices[0];
+
+    // Per-sample modulation from the matrix buffers
+    auto modulationFor = [&](ModulationMatrix::Destination dest) -> const Vec*
+    {
+        return patch.modulation.targets(dest) ? modulationBuffer[dest] : nullptr;
+    };
+
+    const Vec* pitchMod = modulationFor(ModulationMatrix::DestPitch);
+    const Vec* pwmMod = modulationFor(ModulationMatrix::DestPWM);
+
+    const Vec zero = Vec::broadcast(0.0f);
+    const Vec one = Vec::broadcast(1.0f);
+    const Vec two = Vec::broadcast(2.0f);
+    const Vec half = Vec::broadcast(0.5f);
+    const Vec four = Vec::broadcast(4.0f);
+    const Vec invSampleRate = Vec::broadcast(static_cast<float>(1.0 / patch.oscillators[0].sampleRate));
+
+    // Oscillators run at the oversampled rate, modulation at the host rate
+    const int shift = group.oversamplingShift;
+    const int oversampledSamples = numSamples << shift;
+
+    for (int i = 0; i < oversampledSamples; ++i)
+        mixBuffer[i] = zero;
+
+    for (size_t osc = 0; osc < NUM_OSCILLATORS; ++osc)
+    {
+        const auto& settings = patch.oscSettings[osc];
+
+        if (!settings.enabled)
+            continue;
+
+        const Oscillator::Waveform waveform = patch.oscillators[osc].waveform;
+        const Vec gain = Vec::broadcast(settings.gain);
+        const Vec drive = Vec::broadcast(settings.drive);
+        const bool driven = settings.drive > 1.01f;  // Small threshold for floating point precision
+        const Vec basePulseWidth = Vec::broadcast(settings.pulseWidth);
+        const bool wavetableEngine = patch.oscillators[osc].engine == Oscillator::Engine::Wavetable;
+        const Wavetable& wavetable = patch.oscillators[osc].tables->getWavetable();
+
+        // PWM oscillates around 50% (0.25 to 0.75 range)
+        auto pulseWidthAt = [&](int i)
+        {
+            return pwmMod ? clamp(half + pwmMod[i >> shift] * Vec::broadcast(0.25f), 0.01f, 0.99f) : basePulseWidth;
+        };
+
+        Vec phase = group.oscPhase[osc];
+        Vec phaseError = group.oscPhaseError[osc];
+        const Vec baseIncrement = group.oscIncrement[osc];
+        const Vec baseFrequency = group.oscFrequency[osc];
+
+        for (int i = 0; i < oversampledSamples; ++i)
+        {
+            // Vibrato: frequency ratio from the matrix, clamped like Oscillator::setFrequency
+            const Vec dt = pitchMod ? clamp(baseFrequency * pitchMod[i >> shift], 20.0f, 20000.0f) * invSampleRate
+                                    : baseIncrement;
+            const Vec invDt = one / dt;
+
+            Vec sample;
+
+            if (wavetableEngine)
+            {
+                sample = wavetableSample(wavetable, waveform, phase, dt, pulseWidthAt(i));
+            }
+            else
+            {
+                switch (waveform)
+                {
+                    case Oscillator::Waveform::Sine:
+                        sample = sinCycle(phase);
+                        break;
+
+                    case Oscillator::Waveform::Sawtooth:
+                        sample = phase * two - one - polyBLEP(phase, dt, invDt);
+                        break;
+
+                    case Oscillator::Waveform::Square:
+                    {
+                        const Vec pulseWidth = pulseWidthAt(i);
+                        Vec shifted = phase - pulseWidth;
+                        shifted = select(shifted < zero, shifted + one, shifted);
+
+                        sample = select(phase < pulseWidth, one, zero - one)
+                                 - polyBLEP(phase, dt, invDt)
+                                 + polyBLEP(shifted, dt, invDt);
+                        break;
+                    }
+
+                    case Oscillator::Waveform::Triangle:
+                    default:
+                    {
+                        const Vec naive = select(phase < half, phase * four - one, Vec::broadcast(3.0f) - phase * four);
+                        Vec peak = phase - half;
+                        peak = select(peak < zero, peak + one, peak);
+
+                        const Vec slope = four * dt;
+                        sample = naive + polyBLEP(peak, dt, invDt) * slope - polyBLEP(phase, dt, invDt) * slope;
+                        break;
+                    }
+                }
+            }
+
+            if (driven)
+                sample = SIMDOps::tanh(sample * drive);
+
+            mixBuffer[i] = mixBuffer[i] + sample * gain;
+
+            // Kahan summation keeps float phases in step with the scalar double-precision path
+            const Vec step = dt - phaseError;
+            const Vec next = phase + step;
+            phaseError = (next - phase) - step;
+            phase = wrap(next);
+        }
+
+        group.oscPhase[osc] = phase;
+        group.oscPhaseError[osc] = phaseError;
+    }
+}
+
+void VoiceLanes::renderNoise(int numSamples)
+{
+    // Noise generators are sequential per voice, so render them one at a time
+    for (int lane = 0; lane < LANES; ++lane)
+    {
+        if (lane < group.numVoices)
+        {
+            group.voices[lane]->noiseGenerator.processBlock(scratch, numSamples);
+
+            for (int i = 0; i < numSamples; ++i)
+                noiseBuffer[i][lane] = scratch[i];
+        }
+        else
+        {
+            for (int i = 0; i < numSamples; ++i)
+                noiseBuffer[i][lane] = 0.0f;
+        }
+    }
+
+    const Vec noiseGain = Vec::broadcast(group.voices[0]->noiseGain);
+
+    // Generated at the host rate (keeps its colour) and held across oversampled samples
+    const int shift = group.oversamplingShift;
+    const int oversampledSamples = numSamples << shift;
+
+    for (int i = 0; i < oversampledSamples; ++i)
+        mixBuffer[i] = mixBuffer[i] + Vec::load(noiseBuffer[i >> shift]) * noiseGain;
+}
+
+void VoiceLanes::renderFilter(int numSamples)
+{
+    const Voice& patch = *group.voices[0];
+    const MoogFilter::Mode mode = patch.filter.mode;
+    const bool zeroDelay = patch.filter.model == MoogFilter::ZeroDelay;
+
+    auto modulationFor = [&](ModulationMatrix::Destination dest) -> const Vec*
+    {
+        return patch.modulation.targets(dest) ? modulationBuffer[dest] : nullptr;
+    };
+
+    const Vec* cutoffMod = modulationFor(ModulationMatrix::DestFilterCutoff);
+    const Vec* resonanceMod = modulationFor(ModulationMatrix::DestFilterRes);
+    const bool modulated = cutoffMod != nullptr || resonanceMod != nullptr;
+
+    const float baseCutoff = patch.baseFilterCutoff;
+    const float baseResonance = patch.baseFilterResonance;
+    const Vec invSampleRate = Vec::broadcast(static_cast<float>(1.0 / patch.filter.sampleRate));
+
+    Vec s1 = group.stage1, s2 = group.stage2, s3 = group.stage3, s4 = group.stage4;
+    Vec g = group.g;
+    Vec feedbackGain = group.feedbackGain;
+    Vec outputGain = group.outputGain;
+
+    const Vec zero = Vec::broadcast(0.0f);
+    const Vec one = Vec::broadcast(1.0f);
+
+    // Same coefficient formulas as MoogFilter::computeCoefficients, evaluated per lane
+    // for the modulation values at host-rate sample index
+    auto coefficientsAt = [&](int index, Vec& gOut, Vec& feedbackOut, Vec& outputOut)
+    {
+        const Vec cutoff = cutoffMod ? clamp(Vec::broadcast(baseCutoff) + cutoffMod[index] * Vec::broadcast(baseCutoff * 2.0f), 20.0f, 12000.0f)
+                                     : clamp(Vec::broadcast(baseCutoff), 20.0f, 12000.0f);
+        const Vec resonance = resonanceMod ? clamp(Vec::broadcast(baseResonance) + resonanceMod[index] * Vec::broadcast(0.5f), 0.0f, 1.0f)
+                                           : clamp(Vec::broadcast(baseResonance), 0.0f, 1.0f);
+
+        const Vec normalizedCutoff = clamp(cutoff * invSampleRate, 0.0f, 0.45f);
+        const Vec warped = clamp(SIMDOps::tan(normalizedCutoff * Vec::broadcast(static_cast<float>(M_PI))), 0.0f, 10.0f);
+
+        if (zeroDelay)
+        {
+            gOut = warped / (one + warped);
+            feedbackOut = resonance * Vec::broadcast(4.0f);
+            outputOut = one + feedbackOut * Vec::broadcast(0.25f);
+            return;
+        }
+
+        gOut = min(warped, Vec::broadcast(1.2f));
+
+        const Vec highCutoffReduction = clamp(one - max(cutoff - Vec::broadcast(8000.0f), zero) * Vec::broadcast(0.4f / 4000.0f), 0.6f, 1.0f);
+        feedbackOut = resonance * Vec::broadcast(3.5f) * highCutoffReduction;
+
+        const Vec cutoffRatio = clamp((Vec::broadcast(12000.0f) - cutoff) * Vec::broadcast(1.0f / 4000.0f), 0.2f, 1.0f);
+        outputOut = one + feedbackOut * Vec::broadcast(0.15f) * cutoffRatio;
+    };
+
+    // No NaN checks or clamps per sample: the state is checked once per chunk below
+    auto filterSample = [&](int i)
+    {
+        Vec inputWithFeedback, y1, y4;
+
+        if (zeroDelay)
+        {
+            // See MoogFilter::zeroDelaySample
+            const Vec g2 = g * g;
+            const Vec S = (one - g) * (((g * s1 + s2) * g + s3) * g + s4);
+            inputWithFeedback = (mixBuffer[i] - feedbackGain * S) / (one + feedbackGain * g2 * g2);
+            const Vec saturatedInput = SIMDOps::tanh(inputWithFeedback);
+
+            Vec v = (saturatedInput - s1) * g;
+            y1 = v + s1;
+            s1 = y1 + v;
+
+            v = (y1 - s2) * g;
+            const Vec y2 = v + s2;
+            s2 = y2 + v;
+
+            v = (y2 - s3) * g;
+            const Vec y3 = v + s3;
+            s3 = y3 + v;
+
+            v = (y3 - s4) * g;
+            y4 = v + s4;
+            s4 = y4 + v;
+        }
+        else
+        {
+            inputWithFeedback = mixBuffer[i] - s4 * feedbackGain;
+            const Vec saturatedInput = SIMDOps::tanh(inputWithFeedback);
+
+            s1 = s1 + g * (saturatedInput - s1);
+            s2 = s2 + g * (s1 - s2);
+            s3 = s3 + g * (s2 - s3);
+            s4 = s4 + g * (s3 - s4);
+
+            y1 = s1;
+            y4 = s4;
+        }
+
+        Vec out;
+
+        switch (mode)
+        {
+            case MoogFilter::BandPass: out = y1 - y4; break;
+            case MoogFilter::HighPass: out = inputWithFeedback - y4; break;
+            case MoogFilter::LowPass:
+            default:                   out = y4; break;
+        }
+
+        mixBuffer[i] = out * outputGain;
+    };
+
+    // Filter runs at the oversampled rate, modulation at the host rate
+    const int shift = group.oversamplingShift;
+
+    if (!modulated)
+    {
+        for (int i = 0; i < (numSamples << shift); ++i)
+            filterSample(i);
+    }
+    else
+    {
+        // Control rate, like Voice::renderChunk: start on the modulated values,
+        // then glide from one matrix control point to the next
+        coefficientsAt(0, g, feedbackGain, outputGain);
+
+        for (int i = 0; i < (1 << shift); ++i)
+            filterSample(i);
+
+        for (int previous = 0; previous < numSamples - 1;)
+        {
+            const int next = std::min(previous + patch.controlInterval, numSamples - 1);
+            const int first = (previous + 1) << shift;
+            const int last = ((next + 1) << shift) - 1;
+            previous = next;
+
+            Vec gTarget, feedbackTarget, outputTarget;
+            coefficientsAt(next, gTarget, feedbackTarget, outputTarget);
+
+            const Vec scale = Vec::broadcast(1.0f / static_cast<float>(last - first + 1));
+            const Vec gStep = (gTarget - g) * scale;
+            const Vec feedbackStep = (feedbackTarget - feedbackGain) * scale;
+            const Vec outputStep = (outputTarget - outputGain) * scale;
+
+            for (int i = first; i < last; ++i)
+            {
+                g = g + gStep;
+                feedbackGain = feedbackGain + feedbackStep;
+                outputGain = outputGain + outputStep;
+                filterSample(i);
+            }
+
+            // Land exactly on the target, like MoogFilter::stepRamp
+            g = gTarget;
+            feedbackGain = feedbackTarget;
+            outputGain = outputTarget;
+            filterSample(last);
+        }
+    }
+
+    // Block-level stability check (see MoogFilter::checkStability): lanes whose
+    // state ran away or went NaN are reset and silenced for this chunk
+    const Vec limit = Vec::broadcast(MoogFilter::STATE_LIMIT);
+    const Vec negativeLimit = Vec::broadcast(-MoogFilter::STATE_LIMIT);
+    auto withinLimit = [&](Vec stage) { return (stage <= limit) & (stage >= negativeLimit); };
+    const auto stable = withinLimit(s1) & withinLimit(s2) & withinLimit(s3) & withinLimit(s4);
+
+    bool allStable = true;
+
+    for (int lane = 0; lane < group.numVoices; ++lane)
+    {
+        if (!laneOf(stable, lane))
+        {
+            ++group.voices[lane]->filter.instabilityResets;
+            allStable = false;
+        }
+    }
+
+    if (!allStable)
+    {
+        s1 = select(stable, s1, zero);
+        s2 = select(stable, s2, zero);
+        s3 = select(stable, s3, zero);
+        s4 = select(stable, s4, zero);
+
+        for (int i = 0; i < (numSamples << shift); ++i)
+            mixBuffer[i] = select(stable, mixBuffer[i], zero);
+    }
+
+    group.stage1 = s1;
+    group.stage2 = s2;
+    group.stage3 = s3;
+    group.stage4 = s4;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Voice.h"
+#include "SIMDOps.h"
+
+/**
+ * VoiceLanes - Voice-parallel (structure-of-arrays) renderer
+ *
+ * Renders groups of LANES voices at once. For each group, oscillator phases
+ * and increments, filter stages, envelope levels and LFO phases are loaded
+ * from the Voice objects into SIMD lane vectors, processed together sample by
+ * sample, and written back afterwards. Voices keep owning their state, so
+ * VoiceManager can switch between this renderer and Voice::renderBlock at any
+ * block boundary without glitches.
+ *
+ * All voices share the same patch parameters (VoiceManager broadcasts them),
+ * so waveform, mode and modulation routing dispatch happens once per block. Only
+ * note-dependent state differs per lane.
+ *
+ * Noise generation stays per voice (its generators are sequential) and is
+ * fed into the lanes as a buffer.
+ *
+ * With oversampling, oscillators and filter run at the voices' oversampled
+ * rate and a lane-parallel decimator brings the mix back to the host rate.
+ */
+class VoiceLanes
+{
+public:
+    static constexpr int LANES = SIMDOps::FloatVec::size;
+
+    /**
+     * Render a set of active voices and add their sum to output
+     * @param voices Active voices (all sharing the same patch parameters)
+     * @param numVoices Number of entries in voices
+     * @param output Buffer to accumulate into
+     * @param numSamples Number of samples to render
+     */
+    void render(Voice* const* voices, int numVoices, float* output, int numSamples);
+
+private:
+    using Vec = SIMDOps::FloatVec;
+
+    static constexpr int BLOCK_SIZE = Voice::MAX_BLOCK_SIZE;
+    static constexpr int NUM_OSCILLATORS = Voice::NUM_OSCILLATORS;
+
+    // Lane-parallel copy of the per-voice state for one group
+    struct Group
+    {
+        Voice* voices[LANES] {};
+        int numVoices = 0;
+
+        // Oscillators
+        Vec oscPhase[NUM_OSCILLATORS];
+        Vec oscPhaseError[NUM_OSCILLATORS];  // Compensated summation (voices keep double phases)
+        Vec oscIncrement[NUM_OSCILLATORS];
+        Vec oscFrequency[NUM_OSCILLATORS];   // Unmodulated, for vibrato
+
+        // Filter
+        Vec stage1, stage2, stage3, stage4;
+        Vec g, feedbackGain, outputGain;
+
+        // Envelope
+        Vec envLevel, envPhase, envVelocity, envReleaseRate;
+
+        // LFOs
+        Vec lfoPhase[2], lfoLastPhase[2], lfoIncrement[2], lfoHold[2];
+
+        // Per-note modulation sources
+        Vec noteVelocity, noteOffset;
+
+        // Output peak per lane (voice sleep)
+        Vec outputPeak;
+
+        // Oversampling
+        int oversamplingFactor = 1;
+        int oversamplingShift = 0;
+        Oversampling::Decimator<Vec> decimator;
+    };
+
+    Group group;
+
+    // Per-chunk lane buffers
+    Vec lfoBuffer[2][BLOCK_SIZE];
+    Vec envelopeBuffer[BLOCK_SIZE];
+    Vec modulationBuffer[ModulationMatrix::NumDestinations][BLOCK_SIZE];  // Pitch as frequency ratio
+    Vec mixBuffer[BLOCK_SIZE * Oversampling::MAX_FACTOR];  // Oversampled until decimated
+    float noiseBuffer[BLOCK_SIZE][LANES];
+    float scratch[BLOCK_SIZE];
+
+    void loadGroup(Voice* const* voices, int numVoices);
+    void storeGroup();
+    void renderChunk(float* output, int numSamples);
+
+    void renderLFO(int lfoIndex, int numSamples);
+    void renderEnvelope(int numSamples);
+    void renderModulation(int numSamples);
+    void renderOscillators(int numSamples);
+    void renderNoise(int numSamples);
+    void renderFilter(int numSamples);
+};
@@ -1,17 +1,120 @@
 #include "VoiceManager.h"
+#include <algorithm>
 #include <cmath>
 
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+namespace
+{
+    /**
+     * Index of the lowest set bit (bits must not be 0)
+     */
+    int lowestSetBit(uint64_t bits)
+    {
+       #if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return static_cast<int>(index);
+       #else
+        return __builtin_ctzll(bits);
+       #endif
+    }
+}
+
 VoiceManager::VoiceManager()
+    : voices(DEFAULT_VOICES)
+{
+    seedVoices();
+    setSilenceThreshold(DEFAULT_SILENCE_THRESHOLD_DB);
+    rebuildActiveVoices();
+
+    for (int i = 0; i < MAX_RENDER_SLICES; ++i)
+        renderJobs.push_back(std::make_unique<RenderJob>());
+}
+
+void VoiceManager::prepare(double sampleRate, int numVoices)
+{
+    numVoices = std::clamp(numVoices, 1, MAX_VOICES);
+
+    if (numVoices != static_cast<int>(voices.size()))
+    {
+        // New voices start as silent copies of the first one, so they carry the current patch
+        Voice prototype = voices[0];
+        prototype.reset();
+        voices.resize(static_cast<size_t>(numVoices), prototype);
+
+        // Copies start with the prototype's random state
+        seedVoices();
+
+        // The voices may have moved
+        rebuildActiveVoices();
+    }
+
+    polyphony = std::min(polyphony, numVoices);
+    unisonVoices = std::min(unisonVoices, numVoices);
+
+    resetGlobalLFOs();
+    setSampleRate(sampleRate);
+}
+
+void VoiceManager::seedVoices()
+{
+    // One random stream per voice, fixed by the instance seed and its index
+    for (size_t i = 0; i < voices.size(); ++i)
+    {
+        voices[i].setRandomSeed(randomSeed + static_cast<uint32_t>(i + 1));
+    }
+
+    for (size_t i = 0; i < globalLFOs.size(); ++i)
+    {
+        globalLFOs[i].setSeed(randomSeed ^ (0x5A5A5A5Au + static_cast<uint32_t>(i)));
+    }
+}
+
+void VoiceManager::setRandomSeed(uint32_t seed)
 {
+    randomSeed = seed;
+    seedVoices();
+
+    // The global LFOs free-run across notes, so a seeded restart also restarts
+    // them (after seeding, so their first sample & hold value is seeded too)
+    resetGlobalLFOs();
+}
+
+void VoiceManager::resetGlobalLFOs()
+{
+    for (auto& lfo : globalLFOs)
+    {
+        lfo.reset();
+    }
 }
 
 void VoiceManager::setSampleRate(double sampleRate)
 {
+    currentSampleRate = sampleRate;
+
     // Broadcast sample rate to all voices
     for (auto& voice : voices)
     {
         voice.setSampleRate(sampleRate);
     }
+
+    for (auto& lfo : globalLFOs)
+    {
+        lfo.setSampleRate(sampleRate);
+    }
+
+    silenceHoldSamples = static_cast<int>(SILENCE_HOLD_SECONDS * sampleRate);
+}
+
+void VoiceManager::setOversampling(int factor)
+{
+    for (auto& voice : voices)
+    {
+        voice.setOversampling(factor);
+    }
 }
 
 void VoiceManager::setVoiceMode(VoiceMode mode)
@@ -30,6 +133,31 @@ void VoiceManager::setUnisonDetune(float detuneCents)
     unisonDetuneAmount = detuneCents;
 }
 
+void VoiceManager::setPolyphony(int numVoices)
+{
+    numVoices = std::clamp(numVoices, 1, static_cast<int>(voices.size()));
+
+    // Voices that are no longer available finish their release instead of cutting off
+    if (numVoices < polyphony && voiceMode == VoiceMode::Poly)
+    {
+        releaseVoicesFrom(numVoices);
+    }
+
+    polyphony = numVoices;
+}
+
+void VoiceManager::setUnisonVoices(int numVoices)
+{
+    numVoices = std::clamp(numVoices, 1, static_cast<int>(voices.size()));
+
+    if (numVoices < unisonVoices && voiceMode == VoiceMode::Unison)
+    {
+        releaseVoicesFrom(numVoices);
+    }
+
+    unisonVoices = numVoices;
+}
+
 void VoiceManager::noteOn(int midiNote, float velocity)
 {
     // Dispatch to appropriate allocation strategy based on mode
@@ -48,15 +176,21 @@ void VoiceManager::noteOn(int midiNote, float velocity)
             break;
     }
 
-    // Increment age of all voices for LRU tracking
-    incrementAllAges();
+    // Synced LFOs of the new voice(s) pick up the transport phase instead of restarting
+    if (transportLocked)
+        syncLFOsToTransport();
 }
 
 void VoiceManager::noteOff(int midiNote)
 {
-    // Find all voices playing this note and release them
-    for (auto& voice : voices)
+    if (midiNote < 0 || midiNote >= NUM_MIDI_NOTES)
+        return;
+
+    // Release all voices playing this note
+    for (int i = firstVoiceForNote[static_cast<size_t>(midiNote)]; i >= 0; i = nextVoiceForNote[static_cast<size_t>(i)])
     {
+        Voice& voice = voices[static_cast<size_t>(i)];
+
         if (voice.getCurrentNote() == midiNote && voice.isActive())
         {
             voice.noteOff();
@@ -67,11 +201,13 @@ void VoiceManager::noteOff(int midiNote)
 void VoiceManager::allNotesOff()
 {
     // Send note-off to all active voices (releases envelopes)
-    for (auto& voice : voices)
+    for (int i = 0; i < numActiveVoices; ++i)
     {
-        if (voice.isActive())
+        Voice* voice = activeVoices[static_cast<size_t>(i)];
+
+        if (voice->isActive())
         {
-            voice.noteOff();
+            voice->noteOff();
         }
     }
 }
@@ -83,6 +219,8 @@ void VoiceManager::allSoundOff()
     {
         voice.reset();
     }
+
+    rebuildActiveVoices();
 }
 
 //==============================================================================
@@ -105,6 +243,14 @@ void VoiceManager::setOscillatorWaveform(int oscIndex, Oscillator::Waveform wave
     }
 }
 
+void VoiceManager::setOscillatorEngine(int oscIndex, Oscillator::Engine engine)
+{
+    for (auto& voice : voices)
+    {
+        voice.setOscillatorEngine(oscIndex, engine);
+    }
+}
+
 void VoiceManager::setOscillatorGain(int oscIndex, float gain)
 {
     for (auto& voice : voices)
@@ -198,6 +344,14 @@ void VoiceManager::setFilterMode(MoogFilter::Mode mode)
     }
 }
 
+void VoiceManager::setFilterModel(MoogFilter::Model model)
+{
+    for (auto& voice : voices)
+    {
+        voice.setFilterModel(model);
+    }
+}
+
 void VoiceManager::setFilterCutoff(float cutoffHz)
 {
     for (auto& voice : voices)
@@ -224,6 +378,8 @@ void VoiceManager::setLFO1Waveform(LFO::Waveform waveform)
     {
         voice.setLFO1Waveform(waveform);
     }
+
+    globalLFOs[0].setWaveform(waveform);
 }
 
 void VoiceManager::setLFO1Rate(float rateHz)
@@ -232,6 +388,8 @@ void VoiceManager::setLFO1Rate(float rateHz)
     {
         voice.setLFO1Rate(rateHz);
     }
+
+    globalLFOs[0].setRate(rateHz);
 }
 
 void VoiceManager::setLFO1Depth(float depth)
@@ -240,6 +398,8 @@ void VoiceManager::setLFO1Depth(float depth)
     {
         voice.setLFO1Depth(depth);
     }
+
+    globalLFOs[0].setDepth(depth);
 }
 
 void VoiceManager::setLFO1Destination(int dest)
@@ -256,6 +416,8 @@ void VoiceManager::setLFO2Waveform(LFO::Waveform waveform)
     {
         voice.setLFO2Waveform(waveform);
     }
+
+    globalLFOs[1].setWaveform(waveform);
 }
 
 void VoiceManager::setLFO2Rate(float rateHz)
@@ -264,6 +426,8 @@ void VoiceManager::setLFO2Rate(float rateHz)
     {
         voice.setLFO2Rate(rateHz);
     }
+
+    globalLFOs[1].setRate(rateHz);
 }
 
 void VoiceManager::setLFO2Depth(float depth)
@@ -272,6 +436,8 @@ void VoiceManager::setLFO2Depth(float depth)
     {
         voice.setLFO2Depth(depth);
     }
+
+    globalLFOs[1].setDepth(depth);
 }
 
 void VoiceManager::setLFO2Destination(int dest)
@@ -288,6 +454,8 @@ void VoiceManager::setLFO1RateMode(LFO::RateMode mode)
     {
         voice.setLFO1RateMode(mode);
     }
+
+    globalLFOs[0].setRateMode(mode);
 }
 
 void VoiceManager::setLFO1SyncDivision(LFO::SyncDivision division)
@@ -296,6 +464,8 @@ void VoiceManager::setLFO1SyncDivision(LFO::SyncDivision division)
     {
         voice.setLFO1SyncDivision(division);
     }
+
+    globalLFOs[0].setSyncDivision(division);
 }
 
 void VoiceManager::setLFO1BPM(float bpm)
@@ -304,6 +474,8 @@ void VoiceManager::setLFO1BPM(float bpm)
     {
         voice.setLFO1BPM(bpm);
     }
+
+    globalLFOs[0].setBPM(bpm);
 }
 
 void VoiceManager::setLFO2RateMode(LFO::RateMode mode)
@@ -312,6 +484,8 @@ void VoiceManager::setLFO2RateMode(LFO::RateMode mode)
     {
         voice.setLFO2RateMode(mode);
     }
+
+    globalLFOs[1].setRateMode(mode);
 }
 
 void VoiceManager::setLFO2SyncDivision(LFO::SyncDivision division)
@@ -320,6 +494,8 @@ void VoiceManager::setLFO2SyncDivision(LFO::SyncDivision division)
     {
         voice.setLFO2SyncDivision(division);
     }
+
+    globalLFOs[1].setSyncDivision(division);
 }
 
 void VoiceManager::setLFO2BPM(float bpm)
@@ -328,6 +504,93 @@ void VoiceManager::setLFO2BPM(float bpm)
     {
         voice.setLFO2BPM(bpm);
     }
+
+    globalLFOs[1].setBPM(bpm);
+}
+
+void VoiceManager::setLFO1Global(bool global)
+{
+    setLFOGlobal(0, global);
+}
+
+void VoiceManager::setLFO2Global(bool global)
+{
+    setLFOGlobal(1, global);
+}
+
+void VoiceManager::setLFOGlobal(int lfoIndex, bool global)
+{
+    lfoGlobal[static_cast<size_t>(lfoIndex)] = global;
+
+    // Voices read the shared buffer instead of running their own LFO
+    const float* buffer = global ? globalLFOBuffers[static_cast<size_t>(lfoIndex)].data() : nullptr;
+
+    for (auto& voice : voices)
+    {
+        voice.setSharedLFOBuffer(lfoIndex, buffer);
+    }
+}
+
+void VoiceManager::setTransportPosition(double ppqPosition, float bpm)
+{
+    transportLocked = true;
+    transportPosition = ppqPosition;
+    transportBeatsPerSample = bpm / (60.0 * currentSampleRate);
+
+    syncLFOsToTransport();
+}
+
+void VoiceManager::clearTransportPosition()
+{
+    transportLocked = false;
+}
+
+void VoiceManager::syncLFOsToTransport()
+{
+    for (auto& voice : voices)
+    {
+        voice.setLFOTransportPosition(transportPosition);
+    }
+
+    for (auto& lfo : globalLFOs)
+    {
+        lfo.setTransportPosition(transportPosition);
+    }
+}
+
+void VoiceManager::advanceTransport(int numSamples)
+{
+    if (transportLocked)
+        transportPosition += numSamples * transportBeatsPerSample;
+}
+
+//==============================================================================
+// Modulation Matrix
+//==============================================================================
+
+void VoiceManager::setModulationSlot(int userSlot, ModulationMatrix::Source source,
+                                     ModulationMatrix::Destination destination, float amount)
+{
+    for (auto& voice : voices)
+    {
+        voice.setModulationSlot(userSlot, source, destination, amount);
+    }
+}
+
+void VoiceManager::setModWheel(float value)
+{
+    for (auto& voice : voices)
+    {
+        voice.setModWheel(value);
+    }
+}
+
+void VoiceManager::setControlInterval(int numSamples)
+{
+    for (auto& voice : voices)
+    {
+        voice.setControlInterval(numSamples);
+    }
 }
 
 //==============================================================================
@@ -337,118 +600,344 @@ void VoiceManager::setLFO2BPM(float bpm)
 float VoiceManager::processSample()
 {
     float output = 0.0f;
-    int activeCount = 0;
+
+    renderGlobalLFOs(1);
 
     // Sum output from all active voices
     // Each voice now handles its own 3 oscillators + noise mixing with envelope
-    for (auto& voice : voices)
+    for (int i = 0; i < numActiveVoices; ++i)
+    {
+        output += activeVoices[static_cast<size_t>(i)]->processSample();
+    }
+
+    updateActiveVoices(1);
+    advanceTransport(1);
+
+    // Apply gain compensation based on mode
+    return output * getOutputGain();
+}
+
+void VoiceManager::renderBlock(float* output, int numSamples)
+{
+    std::fill(output, output + numSamples, 0.0f);
+
+    if (lfoGlobal[0] || lfoGlobal[1])
     {
-        if (voice.isActive())
+        // Global LFOs run once per chunk (whether or not voices are playing,
+        // so their phase is continuous) and every voice reads that chunk
+        for (int offset = 0; offset < numSamples; offset += Voice::MAX_BLOCK_SIZE)
         {
-            output += voice.processSample();
-            ++activeCount;
+            const int chunkSize = std::min(Voice::MAX_BLOCK_SIZE, numSamples - offset);
+
+            renderGlobalLFOs(chunkSize);
+            renderActiveVoices(activeVoices.data(), numActiveVoices, output + offset, chunkSize);
         }
     }
+    else
+    {
+        renderActiveVoices(activeVoices.data(), numActiveVoices, output, numSamples);
+    }
 
-    // Apply gain compensation based on mode
-    if (activeCount > 0)
+    updateActiveVoices(numSamples);
+    advanceTransport(numSamples);
+
+    // Mono plays at unity gain
+    if (voiceMode != VoiceMode::Mono)
+    {
+        const float gain = getOutputGain();
+
+        for (int i = 0; i < numSamples; ++i)
+            output[i] *= gain;
+    }
+}
+
+void VoiceManager::renderBlock(float* output, int startSample, int numSamples)
+{
+    renderBlock(output + startSample, numSamples);
+}
+
+void VoiceManager::renderGlobalLFOs(int numSamples)
+{
+    for (size_t i = 0; i < globalLFOs.size(); ++i)
+    {
+        if (lfoGlobal[i])
+            globalLFOs[i].processBlock(globalLFOBuffers[i].data(), numSamples);
+    }
+}
+
+void VoiceManager::renderActiveVoices(Voice* const* voiceList, int numVoices, float* output, int numSamples)
+{
+    if (numVoices > RENDER_SLICE_VOICES)
+    {
+        renderVoiceSlices(voiceList, numVoices, output, numSamples);
+    }
+    else
+    {
+        renderVoices(voiceList, numVoices, voiceLanes, output, numSamples);
+    }
+}
+
+void VoiceManager::renderVoices(Voice* const* voiceList, int numVoices, VoiceLanes& lanes, float* output, int numSamples)
+{
+    if (simdRenderingEnabled && numVoices > 1)
+    {
+        // Several voices: render them side by side in SIMD lanes
+        lanes.render(voiceList, numVoices, output, numSamples);
+    }
+    else
     {
-        if (voiceMode == VoiceMode::Unison)
+        // Each voice renders the whole block and adds itself to the output
+        for (int i = 0; i < numVoices; ++i)
         {
-            // Unison: Light fixed gain for massive sound
-            output /= 2.5f;
+            voiceList[i]->renderBlock(output, numSamples);
+        }
+    }
+}
+
+void VoiceManager::renderVoiceSlices(Voice* const* voiceList, int numVoices, float* output, int numSamples)
+{
+    // Split the voices into fixed slices - one per job. The slicing (and so the
+    // float sum) depends only on the voice count, never on the number of threads
+    const int numJobs = (numVoices + RENDER_SLICE_VOICES - 1) / RENDER_SLICE_VOICES;
+
+    for (int j = 0; j < numJobs; ++j)
+    {
+        const int first = j * RENDER_SLICE_VOICES;
+
+        RenderJob& job = *renderJobs[static_cast<size_t>(j)];
+        job.voices = voiceList + first;
+        job.numVoices = std::min(RENDER_SLICE_VOICES, numVoices - first);
+    }
+
+    for (int offset = 0; offset < numSamples; offset += Voice::MAX_BLOCK_SIZE)
+    {
+        parallelChunkSize = std::min(Voice::MAX_BLOCK_SIZE, numSamples - offset);
+
+        if (renderPool != nullptr)
+        {
+            renderPool->run(numJobs, &VoiceManager::renderJob, this);
         }
-        else if (voiceMode == VoiceMode::Poly)
+        else
         {
-            // Poly: Fixed gain (don't normalize by count to avoid clicks)
-            // Professional synths use fixed gain, not dynamic normalization
-            output /= 2.0f;
+            for (int j = 0; j < numJobs; ++j)
+                renderJob(this, j);
+        }
+
+        // Sum in job order so the result doesn't depend on thread scheduling
+        for (int j = 0; j < numJobs; ++j)
+        {
+            const float* jobOutput = renderJobs[static_cast<size_t>(j)]->buffer.data();
+
+            for (int i = 0; i < parallelChunkSize; ++i)
+                output[offset + i] += jobOutput[i];
         }
-        // Mono: No gain adjustment needed (single voice)
     }
+}
+
+void VoiceManager::renderJob(void* context, int jobIndex)
+{
+    auto& manager = *static_cast<VoiceManager*>(context);
+    auto& job = *manager.renderJobs[static_cast<size_t>(jobIndex)];
+
+    std::fill(job.buffer.begin(), job.buffer.begin() + manager.parallelChunkSize, 0.0f);
+    manager.renderVoices(job.voices, job.numVoices, job.lanes, job.buffer.data(), manager.parallelChunkSize);
+}
+
+void VoiceManager::setNumRenderThreads(int numThreads)
+{
+    // Stop the old workers first
+    renderPool.reset();
+
+    if (numThreads <= 0)
+        return;
+
+    // The audio thread helps out, so numThreads + 1 slices render at a time
+    renderPool = std::make_unique<VoiceRenderPool>(numThreads);
+}
+
+float VoiceManager::getOutputGain() const
+{
+    switch (voiceMode)
+    {
+        case VoiceMode::Unison:
+            // Unison: Light fixed gain for massive sound
+            return 1.0f / 2.5f;
+
+        case VoiceMode::Poly:
+            // Poly: Fixed gain (don't normalize by count to avoid clicks)
+            return 1.0f / 2.0f;
 
-    return output;
+        case VoiceMode::Mono:
+        default:
+            // Mono: No gain adjustment needed (single voice)
+            return 1.0f;
+    }
 }
 
 int VoiceManager::getNumActiveVoices() const
+{
+    return numActiveVoices;
+}
+
+void VoiceManager::setSilenceThreshold(float decibels)
+{
+    silenceThreshold = std::pow(10.0f, decibels / 20.0f);
+}
+
+int VoiceManager::getFilterInstabilityResets() const
 {
     int count = 0;
     for (const auto& voice : voices)
     {
-        if (voice.isActive())
-        {
-            ++count;
-        }
+        count += voice.getFilterInstabilityResets();
     }
     return count;
 }
 
 //==============================================================================
-// Voice Allocation Helpers
+// Active Voice List
 //==============================================================================
 
-Voice* VoiceManager::findFreeVoice()
+void VoiceManager::startVoice(Voice& voice, int midiNote, float velocity, float detune, bool randomizePhase)
 {
-    // Look for a voice that's not active (envelope is idle)
-    for (auto& voice : voices)
+    const int index = indexOf(&voice);
+
+    if (!voice.isActive())
     {
-        if (!voice.isActive())
-        {
-            return &voice;
-        }
+        activeVoices[static_cast<size_t>(numActiveVoices++)] = &voice;
+        freeVoices &= ~(uint64_t { 1 } << index);
     }
 
-    return nullptr;  // No free voices available
+    if (linkedNote[static_cast<size_t>(index)] != midiNote)
+    {
+        unlinkVoiceFromNote(index);
+        linkVoiceToNote(index, midiNote);
+    }
+
+    voice.setStartOrder(++allocationCounter);
+    voice.noteOn(midiNote, velocity, detune, randomizePhase);
 }
 
-Voice* VoiceManager::findVoicePlayingNote(int midiNote)
+void VoiceManager::updateActiveVoices(int numSamples)
 {
-    // Find a voice currently playing this MIDI note
-    for (auto& voice : voices)
+    // Keep the voices that are still playing, in order; free the others
+    int kept = 0;
+
+    for (int i = 0; i < numActiveVoices; ++i)
     {
-        if (voice.getCurrentNote() == midiNote && voice.isActive())
+        Voice* voice = activeVoices[static_cast<size_t>(i)];
+
+        if (voice->isActive() && !voice->sleepIfSilent(silenceThreshold, numSamples, silenceHoldSamples))
+        {
+            activeVoices[static_cast<size_t>(kept++)] = voice;
+        }
+        else
         {
-            return &voice;
+            const int index = indexOf(voice);
+            unlinkVoiceFromNote(index);
+            freeVoices |= uint64_t { 1 } << index;
         }
     }
 
-    return nullptr;  // Note not currently playing
+    numActiveVoices = kept;
 }
 
-Voice* VoiceManager::stealVoice()
+void VoiceManager::rebuildActiveVoices()
 {
-    // Least Recently Used (LRU) voice stealing algorithm
-    // Prefer voices in release phase, then oldest voice
+    numActiveVoices = 0;
+    freeVoices = 0;
+    firstVoiceForNote.fill(-1);
+    linkedNote.fill(-1);
 
-    Voice* candidate = nullptr;
-    int maxAge = -1;
-
-    // First pass: Find oldest voice in release phase
-    for (auto& voice : voices)
+    for (size_t i = 0; i < voices.size(); ++i)
     {
-        if (voice.isActive() && !voice.isSounding() && voice.getAge() > maxAge)
+        const int index = static_cast<int>(i);
+
+        if (voices[i].isActive())
+        {
+            activeVoices[static_cast<size_t>(numActiveVoices++)] = &voices[i];
+            linkVoiceToNote(index, voices[i].getCurrentNote());
+        }
+        else
         {
-            maxAge = voice.getAge();
-            candidate = &voice;
+            freeVoices |= uint64_t { 1 } << index;
         }
     }
+}
+
+void VoiceManager::linkVoiceToNote(int voiceIndex, int midiNote)
+{
+    if (midiNote < 0 || midiNote >= NUM_MIDI_NOTES)
+        return;
+
+    const auto voice = static_cast<size_t>(voiceIndex);
+    const auto note = static_cast<size_t>(midiNote);
+
+    nextVoiceForNote[voice] = firstVoiceForNote[note];
+    firstVoiceForNote[note] = voiceIndex;
+    linkedNote[voice] = midiNote;
+}
+
+void VoiceManager::unlinkVoiceFromNote(int voiceIndex)
+{
+    const auto voice = static_cast<size_t>(voiceIndex);
+    const int midiNote = linkedNote[voice];
+
+    if (midiNote < 0)
+        return;
+
+    // Chains are short (one voice per note, or the unison stack)
+    int* link = &firstVoiceForNote[static_cast<size_t>(midiNote)];
+
+    while (*link != voiceIndex)
+        link = &nextVoiceForNote[static_cast<size_t>(*link)];
+
+    *link = nextVoiceForNote[voice];
+    linkedNote[voice] = -1;
+}
+
+//==============================================================================
+// Voice Allocation Helpers
+//==============================================================================
 
-    // Second pass: If no releasing voices, steal oldest active voice
-    if (!candidate)
+Voice* VoiceManager::findFreeVoice()
+{
+    // Lowest idle voice among the first `polyphony` voices
+    const uint64_t polyphonyVoices = polyphony >= 64 ? ~uint64_t { 0 } : (uint64_t { 1 } << polyphony) - 1;
+    const uint64_t candidates = freeVoices & polyphonyVoices;
+
+    if (candidates == 0)
+        return nullptr;  // No free voices available
+
+    return &voices[static_cast<size_t>(lowestSetBit(candidates))];
+}
+
+Voice* VoiceManager::stealVoice()
+{
+    // Least Recently Used (LRU) voice stealing algorithm
+    // Prefer the oldest voice in release phase, then the oldest voice
+    Voice* oldestReleased = nullptr;
+    Voice* oldest = nullptr;
+
+    for (int i = 0; i < numActiveVoices; ++i)
     {
-        maxAge = -1;
-        for (auto& voice : voices)
-        {
-            if (voice.isActive() && voice.getAge() > maxAge)
-            {
-                maxAge = voice.getAge();
-                candidate = &voice;
-            }
-        }
+        Voice* voice = activeVoices[static_cast<size_t>(i)];
+
+        if (indexOf(voice) >= polyphony || !voice->isActive())
+            continue;
+
+        if (!voice->isSounding() && (oldestReleased == nullptr || voice->getStartOrder() < oldestReleased->getStartOrder()))
+            oldestReleased = voice;
+
+        if (oldest == nullptr || voice->getStartOrder() < oldest->getStartOrder())
+            oldest = voice;
     }
 
+    if (oldestReleased != nullptr)
+        return oldestReleased;
+
     // Fallback: If still no candidate (shouldn't happen), use first voice
-    return candidate ? candidate : &voices[0];
+    return oldest != nullptr ? oldest : &voices[0];
 }
 
 //==============================================================================
@@ -459,7 +948,7 @@ void VoiceManager::allocateMonoVoice(int midiNote, float velocity)
 {
     // MONO mode: Always use the first voice
     // Last note priority - new note retriggers envelope
-    voices[0].noteOn(midiNote, velocity, 0.0f);
+    startVoice(voices[0], midiNote, velocity);
 }
 
 void VoiceManager::allocatePolyVoice(int midiNote, float velocity)
@@ -480,23 +969,23 @@ void VoiceManager::allocatePolyVoice(int midiNote, float velocity)
     // Trigger the voice (handles both free and stolen voices)
     if (voice)
     {
-        voice->noteOn(midiNote, velocity, 0.0f);
+        startVoice(*voice, midiNote, velocity);
     }
 }
 
 void VoiceManager::allocateUnisonVoices(int midiNote, float velocity)
 {
-    // UNISON mode: All voices play the same note, detuned
+    // UNISON mode: The first unisonVoices voices play the same note, detuned
 
     // Silence any voices that might be ringing
     allSoundOff();
 
     // Trigger all voices with calculated detune amounts and random phases
     // Random phases prevent phaser effect from phase synchronization
-    for (int i = 0; i < MAX_VOICES; ++i)
+    for (int i = 0; i < unisonVoices; ++i)
     {
         float detune = calculateUnisonDetune(i);
-        voices[i].noteOn(midiNote, velocity, detune, true);  // true = randomize phase
+        startVoice(voices[static_cast<size_t>(i)], midiNote, velocity, detune, true);  // true = randomize phase
     }
 }
 
@@ -507,19 +996,20 @@ float VoiceManager::calculateUnisonDetune(int voiceIndex) const
 
     // Center voice has no detune, others spread symmetrically
     // Example for 8 voices at ±10 cents: -10, -7.14, -4.29, -1.43, +1.43, +4.29, +7.14, +10
-    float step = (unisonDetuneAmount * 2.0f) / (MAX_VOICES - 1);
-    return -unisonDetuneAmount + (voiceIndex * step);
+    if (unisonVoices < 2)
+        return 0.0f;
+
+    float step = (unisonDetuneAmount * 2.0f) / static_cast<float>(unisonVoices - 1);
+    return -unisonDetuneAmount + (static_cast<float>(voiceIndex) * step);
 }
 
-void VoiceManager::incrementAllAges()
+void VoiceManager::releaseVoicesFrom(int firstVoice)
 {
-    // Increment age counter for all active voices
-    // Used for LRU voice stealing algorithm
-    for (auto& voice : voices)
+    for (size_t i = static_cast<size_t>(firstVoice); i < voices.size(); ++i)
     {
-        if (voice.isActive())
+        if (voices[i].isActive())
         {
-            voice.incrementAge();
+            voices[i].noteOff();
         }
     }
 }
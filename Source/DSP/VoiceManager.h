@@ -1,15 +1,23 @@
 #pragma once
 
 #include "Voice.h"
+#include "VoiceLanes.h"
+#include "VoiceRenderPool.h"
 #include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
 
 /**
  * VoiceManager - Polyphonic voice management system
  *
  * Manages a pool of voices with three modes:
  * - MONO: Single voice, last note priority
- * - POLY: Up to MAX_VOICES polyphony with voice stealing (LRU)
- * - UNISON: All voices play same note, detuned for thickness
+ * - POLY: Up to `polyphony` voices with voice stealing (LRU)
+ * - UNISON: `unisonVoices` voices play the same note, detuned for thickness
+ *
+ * The pool is sized by prepare() (up to MAX_VOICES); polyphony and unison
+ * voice count can then change at any time without allocating.
  *
  * Python reference: sine_generator_qt.py:4050-4140 (MIDI), 4230-4260 (stealing)
  */
@@ -19,21 +27,43 @@ public:
     enum class VoiceMode
     {
         Mono = 0,   // Single voice, last note priority
-        Poly = 1,   // Up to MAX_VOICES polyphony
+        Poly = 1,   // Up to `polyphony` voices
         Unison = 2  // All voices play same note, detuned
     };
 
-    static constexpr int MAX_VOICES = 8;
+    static constexpr int MAX_VOICES = 64;
+    static constexpr int DEFAULT_VOICES = 8;
+
+    static constexpr float DEFAULT_SILENCE_THRESHOLD_DB = -96.0f;
+    static constexpr double SILENCE_HOLD_SECONDS = 0.02;  // Time below the threshold before a voice sleeps
 
     VoiceManager();
 
     /**
      * Initialization
+     * prepare() allocates - call it from a non-audio thread (e.g. prepareToPlay)
+     * @param numVoices Size of the voice pool (1 - MAX_VOICES)
      */
+    void prepare(double sampleRate, int numVoices);
     void setSampleRate(double sampleRate);
     void setVoiceMode(VoiceMode mode);
     void setUnisonDetune(float detuneCents);  // 5-25 cents
 
+    /**
+     * Voice counts (clamped to the pool size, no allocation)
+     */
+    void setPolyphony(int numVoices);     // Voices available in Poly mode
+    void setUnisonVoices(int numVoices);  // Voices stacked in Unison mode
+    int getPolyphony() const { return polyphony; }
+    int getUnisonVoices() const { return unisonVoices; }
+
+    /**
+     * Oversampling of the oscillator-drive-filter chain (1, 2 or 4)
+     * No allocation; resets the voices' decimators, so change it between notes
+     */
+    void setOversampling(int factor);
+    int getOversampling() const { return voices[0].getOversampling(); }
+
     /**
      * MIDI note handling
      */
@@ -42,6 +72,16 @@ public:
     void allNotesOff();     // Send note-off to all voices
     void allSoundOff();     // Immediate silence
 
+    /**
+     * Restart every random source (noise, unison phases, sample & hold LFOs)
+     * Each voice mixes its index into the instance seed, so voices stay
+     * uncorrelated. Also restarts the global LFOs, which allSoundOff() leaves
+     * running. After allSoundOff() and setRandomSeed() the output depends
+     * only on the seed, the parameters and the incoming MIDI.
+     */
+    void setRandomSeed(uint32_t seed);
+    uint32_t getRandomSeed() const { return randomSeed; }
+
     /**
      * Per-oscillator parameter broadcasting
      */
@@ -52,6 +92,7 @@ public:
     void setOscillatorOctave(int oscIndex, int octaveOffset);
     void setOscillatorPulseWidth(int oscIndex, float pw);
     void setOscillatorDrive(int oscIndex, float drive);
+    void setOscillatorEngine(int oscIndex, Oscillator::Engine engine);
 
     /**
      * Noise parameters (per-voice, controlled by envelope)
@@ -64,6 +105,7 @@ public:
      * Filter parameters (shared by all voices)
      */
     void setFilterMode(MoogFilter::Mode mode);
+    void setFilterModel(MoogFilter::Model model);
     void setFilterCutoff(float cutoffHz);      // 20.0 - 12000.0 Hz
     void setFilterResonance(float resonance);  // 0.0 - 1.0
 
@@ -91,28 +133,168 @@ public:
     void setLFO2SyncDivision(LFO::SyncDivision division);
     void setLFO2BPM(float bpm);
 
+    /**
+     * Global LFO mode: one free-running LFO per instance, rendered once per
+     * block and read by every voice (phase-coherent across notes). Off = each
+     * voice runs its own LFO, retriggered on note-on.
+     */
+    void setLFO1Global(bool global);
+    void setLFO2Global(bool global);
+
+    /**
+     * Host transport position at the start of the next renderBlock() call
+     * Tempo-synced LFOs take their phase from it (relocked at every call, and
+     * on note-on instead of restarting), so renders are reproducible. The
+     * position advances at bpm between calls until the next update.
+     * @param ppqPosition Position in quarter notes
+     * @param bpm Tempo for this block
+     */
+    void setTransportPosition(double ppqPosition, float bpm);
+
+    /**
+     * Host transport stopped or unknown: synced LFOs free-run and restart on note-on
+     */
+    void clearTransportPosition();
+
+    /**
+     * Modulation matrix (shared by all voices)
+     */
+    void setModulationSlot(int userSlot, ModulationMatrix::Source source,
+                           ModulationMatrix::Destination destination, float amount);
+    void setModWheel(float value);
+    void setControlInterval(int numSamples);
+
     /**
      * Audio generation
      * @return Mixed output from all active voices
      */
     float processSample();
 
+    /**
+     * Block audio generation
+     * @param output Buffer to fill with the mixed output of all active voices (overwritten)
+     * @param numSamples Number of samples to render
+     */
+    void renderBlock(float* output, int numSamples);
+
+    /**
+     * Sub-block audio generation, used to split a host block at MIDI events
+     * Only output[startSample] .. output[startSample + numSamples - 1] are written
+     */
+    void renderBlock(float* output, int startSample, int numSamples);
+
+    /**
+     * Render active voices in SIMD lanes (default) or one voice at a time
+     */
+    void setSimdRenderingEnabled(bool enabled) { simdRenderingEnabled = enabled; }
+
+    /**
+     * Parallel rendering across a worker pool
+     * More than RENDER_SLICE_VOICES active voices are always rendered in fixed
+     * slices and summed in slice order, with or without the pool, so the thread
+     * count never changes the output.
+     * Creates/destroys threads - call from a non-audio thread (e.g. prepareToPlay)
+     * @param numThreads Worker threads besides the audio thread (0 = audio thread only)
+     */
+    void setNumRenderThreads(int numThreads);
+
+    /**
+     * Voice sleep: a released voice, or a held one whose envelope has decayed
+     * below this level (e.g. sustain 0), is stopped once its output stays below
+     * this level for SILENCE_HOLD_SECONDS (see Voice::sleepIfSilent)
+     * @param decibels Peak level in dBFS (-infinity disables voice sleep)
+     */
+    void setSilenceThreshold(float decibels);
+
     /**
      * Voice statistics
      */
     int getNumActiveVoices() const;
 
+    /**
+     * Total filter state resets after instability, across all voices
+     * (read on the audio thread or while rendering is stopped)
+     */
+    int getFilterInstabilityResets() const;
+
 private:
     // Voice pool
-    std::array<Voice, MAX_VOICES> voices;
+    std::vector<Voice> voices;
     VoiceMode voiceMode = VoiceMode::Poly;
     float unisonDetuneAmount = 10.0f;  // Default: ±10 cents
 
+    // Voices with an active envelope, in the order they started. Rendering
+    // and voice stealing only visit these, so idle voices cost nothing.
+    std::array<Voice*, MAX_VOICES> activeVoices {};
+    int numActiveVoices = 0;
+
+    // Idle voices, one bit per voice index (the lowest free voice is taken first)
+    static_assert(MAX_VOICES <= 64, "freeVoices holds one bit per voice");
+    uint64_t freeVoices = 0;
+
+    // Voices by MIDI note: a chain per note through nextVoiceForNote (-1 ends it)
+    static constexpr int NUM_MIDI_NOTES = 128;
+    std::array<int, NUM_MIDI_NOTES> firstVoiceForNote {};
+    std::array<int, MAX_VOICES> nextVoiceForNote {};
+    std::array<int, MAX_VOICES> linkedNote {};  // Note each voice is chained under (-1 = none)
+
+    // Stamps note-ons for LRU stealing (replaces per-voice age counters)
+    uint64_t allocationCounter = 0;
+
+    // Voice sleep
+    float silenceThreshold = 0.0f;  // Linear peak (0 = off)
+    int silenceHoldSamples = 0;
+    int polyphony = DEFAULT_VOICES;
+    int unisonVoices = DEFAULT_VOICES;
+    uint32_t randomSeed = 0;
+
+    // Global LFOs (only rendered when their mode is on)
+    std::array<LFO, 2> globalLFOs;
+    std::array<std::array<float, Voice::MAX_BLOCK_SIZE>, 2> globalLFOBuffers {};
+    std::array<bool, 2> lfoGlobal {};
+
+    // Host transport (tempo-synced LFO phase)
+    double currentSampleRate = 44100.0;
+    bool transportLocked = false;
+    double transportPosition = 0.0;  // Quarter notes at the next sample to render
+    double transportBeatsPerSample = 0.0;
+
+    // Voice-parallel block renderer
+    VoiceLanes voiceLanes;
+    bool simdRenderingEnabled = true;
+
+    // Parallel rendering: each job renders a slice of the active voices into its own buffer
+    static constexpr int RENDER_SLICE_VOICES = 8;
+    static constexpr int MAX_RENDER_SLICES = (MAX_VOICES + RENDER_SLICE_VOICES - 1) / RENDER_SLICE_VOICES;
+
+    struct RenderJob
+    {
+        Voice* const* voices = nullptr;
+        int numVoices = 0;
+        VoiceLanes lanes;
+        std::array<float, Voice::MAX_BLOCK_SIZE> buffer {};
+    };
+
+    std::unique_ptr<VoiceRenderPool> renderPool;
+    std::vector<std::unique_ptr<RenderJob>> renderJobs;  // One per slice, used with or without the pool
+    int parallelChunkSize = 0;
+
+    /**
+     * Active list, free voices and note map maintenance
+     * startVoice() triggers a voice, stamps it and files it under its note;
+     * updateActiveVoices() puts silent voices to sleep and frees finished ones
+     */
+    void startVoice(Voice& voice, int midiNote, float velocity, float detune = 0.0f, bool randomizePhase = false);
+    void updateActiveVoices(int numSamples);
+    void rebuildActiveVoices();
+    void linkVoiceToNote(int voiceIndex, int midiNote);
+    void unlinkVoiceFromNote(int voiceIndex);
+    int indexOf(const Voice* voice) const { return static_cast<int>(voice - voices.data()); }
+
     /**
      * Voice allocation helpers
      */
     Voice* findFreeVoice();
-    Voice* findVoicePlayingNote(int midiNote);
     Voice* stealVoice();
 
     /**
@@ -122,14 +304,34 @@ private:
     void allocatePolyVoice(int midiNote, float velocity);
     void allocateUnisonVoices(int midiNote, float velocity);
 
+    /**
+     * Release voices beyond the given count (they fade out with their envelopes)
+     */
+    void releaseVoicesFrom(int firstVoice);
+
     /**
      * Unison detuning calculation
      * Spreads voices across a range for thick sound
      */
     float calculateUnisonDetune(int voiceIndex) const;
 
+    void setLFOGlobal(int lfoIndex, bool global);
+    void seedVoices();
+    void resetGlobalLFOs();
+    void syncLFOsToTransport();
+    void advanceTransport(int numSamples);
+
+    /**
+     * Block rendering helpers
+     */
+    void renderGlobalLFOs(int numSamples);
+    void renderActiveVoices(Voice* const* voiceList, int numVoices, float* output, int numSamples);
+    void renderVoices(Voice* const* voiceList, int numVoices, VoiceLanes& lanes, float* output, int numSamples);
+    void renderVoiceSlices(Voice* const* voiceList, int numVoices, float* output, int numSamples);
+    static void renderJob(void* context, int jobIndex);
+
     /**
-     * Age management for LRU voice stealing
+     * Mode-dependent gain applied to the summed voices
      */
-    void incrementAllAges();
+    float getOutputGain() const;
 };
@@ -0,0 +1,140 @@
+#include "VoiceRenderPool.h"
+#include <chrono>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_IX86)
+  #include <emmintrin.h>
+#endif
+
+namespace
+{
+    // Polls before a worker goes to sleep (a few hundred microseconds)
+    constexpr int SPIN_ITERATIONS = 20000;
+
+    constexpr uint64_t JOB_COUNT_MASK = 0xffffffffu;
+
+    inline void cpuPause()
+    {
+       #if defined(__SSE2__) || defined(_M_X64) || defined(_M_IX86)
+        _mm_pause();
+       #elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+       #else
+        std::this_thread::yield();
+       #endif
+    }
+}
+
+VoiceRenderPool::VoiceRenderPool(int numWorkers)
+{
+    workers.reserve(static_cast<size_t>(numWorkers));
+
+    for (int i = 0; i < numWorkers; ++i)
+        workers.emplace_back([this] { workerLoop(); });
+}
+
+VoiceRenderPool::~VoiceRenderPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        shouldExit.store(true);
+    }
+
+    wakeUp.notify_all();
+
+    for (auto& worker : workers)
+        worker.join();
+}
+
+//==============================================================================
+// Dispatch
+//==============================================================================
+
+void VoiceRenderPool::run(int numJobs, JobFunction function, void* context)
+{
+    if (numJobs <= 0)
+        return;
+
+    jobFunction = function;
+    jobContext = context;
+    jobsRemaining.store(numJobs, std::memory_order_relaxed);
+
+    // Publish the batch (the new generation stops stale claims from the previous one)
+    ++generation;
+    dispatch.store((static_cast<uint64_t>(generation) << 32) | static_cast<uint64_t>(numJobs));
+
+    if (sleepingWorkers.load() > 0)
+        wakeUp.notify_all();
+
+    // The audio thread works too, then waits for jobs still running elsewhere
+    runAvailableJobs();
+
+    while (jobsRemaining.load(std::memory_order_acquire) > 0)
+        cpuPause();
+}
+
+bool VoiceRenderPool::runAvailableJobs()
+{
+    bool ranJob = false;
+    uint64_t current = dispatch.load(std::memory_order_acquire);
+
+    while ((current & JOB_COUNT_MASK) != 0)
+    {
+        if (dispatch.compare_exchange_weak(current, current - 1,
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_acquire))
+        {
+            const int jobIndex = static_cast<int>(current & JOB_COUNT_MASK) - 1;
+            jobFunction(jobContext, jobIndex);
+
+            jobsRemaining.fetch_sub(1, std::memory_order_release);
+            ranJob = true;
+
+            current = dispatch.load(std::memory_order_acquire);
+        }
+    }
+
+    return ranJob;
+}
+
+bool VoiceRenderPool::hasPendingJobs() const
+{
+    return (dispatch.load(std::memory_order_acquire) & JOB_COUNT_MASK) != 0;
+}
+
+//==============================================================================
+// Workers
+//==============================================================================
+
+void VoiceRenderPool::workerLoop()
+{
+    while (!shouldExit.load())
+    {
+        // Spin first: while audio is running the next batch follows shortly
+        bool jobsAvailable = false;
+
+        for (int i = 0; i < SPIN_ITERATIONS && !jobsAvailable; ++i)
+        {
+            jobsAvailable = hasPendingJobs();
+
+            if (!jobsAvailable)
+                cpuPause();
+        }
+
+        if (jobsAvailable)
+        {
+            runAvailableJobs();
+            continue;
+        }
+
+        // Nothing arrived - sleep until the audio thread wakes us.
+        // run() notifies without taking the lock, so a wake-up can slip between the
+        // check and the wait; the timeout bounds that (the audio thread does the work meanwhile).
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepingWorkers.fetch_add(1);
+
+        while (!hasPendingJobs() && !shouldExit.load())
+            wakeUp.wait_for(lock, std::chrono::milliseconds(10));
+
+        sleepingWorkers.fetch_sub(1);
+    }
+}
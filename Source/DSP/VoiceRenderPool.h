@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * VoiceRenderPool - Real-time safe worker pool for parallel voice rendering
+ *
+ * The audio thread hands out a batch of independent jobs with run(), takes
+ * part in the work itself and returns once every job has finished. Dispatch
+ * is lock-free: a single atomic word holds the batch generation and the
+ * number of jobs still to be claimed, and workers claim jobs with a
+ * compare-and-swap. Nothing is allocated after construction.
+ *
+ * Workers spin for a short while after each batch (blocks arrive in quick
+ * succession while audio is running) and then go to sleep until the next
+ * batch. The audio thread never takes a lock; it only wakes sleeping workers.
+ *
+ * Threads are created in the constructor and joined in the destructor, so
+ * the pool must be created and destroyed off the audio thread.
+ */
+class VoiceRenderPool
+{
+public:
+    using JobFunction = void (*)(void* context, int jobIndex);
+
+    /**
+     * @param numWorkers Number of worker threads (the calling thread makes one more)
+     */
+    explicit VoiceRenderPool(int numWorkers);
+    ~VoiceRenderPool();
+
+    VoiceRenderPool(const VoiceRenderPool&) = delete;
+    VoiceRenderPool& operator=(const VoiceRenderPool&) = delete;
+
+    int getNumWorkers() const { return static_cast<int>(workers.size()); }
+
+    /**
+     * Run jobs 0 .. numJobs-1 across the workers and the calling thread
+     * Blocks until every job has completed. Not reentrant.
+     * @param numJobs Number of jobs in the batch
+     * @param function Called once per job, from any thread in the pool
+     * @param context Passed to every call of function
+     */
+    void run(int numJobs, JobFunction function, void* context);
+
+private:
+    // Batch generation (high 32 bits) and jobs left to claim (low 32 bits)
+    std::atomic<uint64_t> dispatch { 0 };
+    std::atomic<int> jobsRemaining { 0 };
+    uint32_t generation = 0;
+
+    // Current batch, written before the batch is published
+    JobFunction jobFunction = nullptr;
+    void* jobContext = nullptr;
+
+    // Sleeping workers
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    std::atomic<int> sleepingWorkers { 0 };
+    std::atomic<bool> shouldExit { false };
+
+    std::vector<std::thread> workers;
+
+    void workerLoop();
+
+    /**
+     * Claim and run jobs of the current batch until none are left
+     * @return true if at least one job was run
+     */
+    bool runAvailableJobs();
+
+    bool hasPendingJobs() const;
+};
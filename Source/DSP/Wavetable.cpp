@@ -0,0 +1,103 @@
+#include "Wavetable.h"
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+    #define M_PI 3.14159265358979323846
+#endif
+
+int Wavetable::levelForIncrement(double phaseIncrement)
+{
+    // Level k holds TABLE_SIZE/2 >> k harmonics; the top one must satisfy
+    // harmonics * increment <= 0.5, i.e. k = ceil(log2(increment * TABLE_SIZE))
+    const double x = phaseIncrement * TABLE_SIZE;
+
+    if (x <= 1.0)
+        return 0;
+
+    // frexp's exponent e gives 2^(e-1) <= y < 2^e. Taking it for the next
+    // double below x makes exact powers of two land one level lower, so
+    // e = ceil(log2(x)) without comparing floats.
+    int level = 0;
+    std::frexp(std::nextafter(x, 0.0), &level);
+
+    return std::min(level, NUM_LEVELS - 1);
+}
+
+Wavetable::Wavetable()
+    : tables(static_cast<size_t>(NumShapes * NUM_LEVELS * STRIDE), 0.0f)
+{
+    buildShape(Sine);
+    buildShape(Sawtooth);
+    buildShape(Triangle);
+}
+
+void Wavetable::buildShape(Shape shape)
+{
+    // One cycle of sin(2*pi*n/N); harmonic k at sample n is sineTable[(k * n) mod N]
+    constexpr size_t size = TABLE_SIZE;
+    constexpr size_t mask = size - 1;
+    constexpr size_t quarterCycle = size / 4;  // cos(x) = sin(x + pi/2)
+
+    std::vector<double> sineTable(size);
+    for (size_t n = 0; n < size; ++n)
+        sineTable[n] = std::sin(2.0 * M_PI * static_cast<double>(n) / TABLE_SIZE);
+
+    // Start at the top level (fewest harmonics) and add harmonics while walking down,
+    // so every harmonic is summed only once
+    std::vector<double> sum(size, 0.0);
+    int harmonicsSoFar = 0;
+
+    for (int level = NUM_LEVELS - 1; level >= 0; --level)
+    {
+        const int numHarmonics = (TABLE_SIZE / 2) >> level;
+
+        for (int k = harmonicsSoFar + 1; k <= numHarmonics; ++k)
+        {
+            switch (shape)
+            {
+                case Sine:
+                    // Fundamental only
+                    if (k == 1)
+                    {
+                        for (size_t n = 0; n < size; ++n)
+                            sum[n] += sineTable[n];
+                    }
+                    break;
+
+                case Sawtooth:
+                {
+                    // 2p - 1 = -(2/pi) * sum sin(2*pi*k*p) / k
+                    const double amplitude = -2.0 / (M_PI * k);
+                    for (size_t n = 0; n < size; ++n)
+                        sum[n] += amplitude * sineTable[(static_cast<size_t>(k) * n) & mask];
+                    break;
+                }
+
+                case Triangle:
+                {
+                    // Starts at -1, peaks at p = 0.5: -(8/pi^2) * sum cos(2*pi*k*p) / k^2 (odd k)
+                    if (k % 2 == 1)
+                    {
+                        const double amplitude = -8.0 / (M_PI * M_PI * k * k);
+                        for (size_t n = 0; n < size; ++n)
+                            sum[n] += amplitude * sineTable[(static_cast<size_t>(k) * n + quarterCycle) & mask];
+                    }
+                    break;
+                }
+
+                case NumShapes:
+                default:
+                    break;
+            }
+        }
+
+        harmonicsSoFar = numHarmonics;
+
+        float* table = tables.data() + (shape * NUM_LEVELS + level) * STRIDE;
+        for (size_t n = 0; n < size; ++n)
+            table[n] = static_cast<float>(sum[n]);
+
+        table[TABLE_SIZE] = table[0];  // Guard sample: wraps for interpolation
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+
+/**
+ * Wavetable - Band-limited, mipmapped single-cycle tables
+ *
+ * One table per octave ("mip level") for each shape. Level 0 holds
+ * TABLE_SIZE/2 harmonics, and every following level halves the harmonic
+ * count, so a note reads from the level whose highest harmonic still sits
+ * below Nyquist. The levels depend only on the phase increment, not on the
+ * sample rate.
+ *
+ * Tables are built once by additive synthesis and are read-only afterwards.
+ * The only instance lives in LookupTables, which shares it between all
+ * voices and plugin instances.
+ *
+ * Square/pulse waves are not stored: a pulse of width pw is the difference
+ * of two sawtooth reads half a pulse apart, which keeps PWM band-limited.
+ */
+class Wavetable
+{
+public:
+    enum Shape
+    {
+        Sine = 0,
+        Sawtooth,
+        Triangle,
+        NumShapes
+    };
+
+    static constexpr int TABLE_SIZE = 2048;               // Samples per cycle (power of two)
+    static constexpr int NUM_LEVELS = 11;                 // 1024, 512, ... 1 harmonics
+    static constexpr int STRIDE = TABLE_SIZE + 1;         // Guard sample for interpolation
+
+    /**
+     * Mip level for a phase increment (frequency / sampleRate)
+     * Picks the richest table whose top harmonic stays below Nyquist
+     */
+    static int levelForIncrement(double phaseIncrement);
+
+    /**
+     * Read a table with linear interpolation
+     * @param shape Table shape
+     * @param level Mip level (see levelForIncrement)
+     * @param phase Phase in [0, 1)
+     */
+    float lookup(Shape shape, int level, double phase) const
+    {
+        const float* table = getTable(shape, level);
+        const double position = phase * TABLE_SIZE;
+        const int index = static_cast<int>(position);
+        const float fraction = static_cast<float>(position - index);
+
+        return table[index] + fraction * (table[index + 1] - table[index]);
+    }
+
+    const float* getTable(Shape shape, int level) const
+    {
+        return tables.data() + (shape * NUM_LEVELS + level) * STRIDE;
+    }
+
+private:
+    friend class LookupTables;  // Owns the shared instance
+
+    Wavetable();
+
+    void buildShape(Shape shape);
+
+    std::vector<float> tables;  // NumShapes x NUM_LEVELS x STRIDE
+};
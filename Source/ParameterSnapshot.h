@@ -0,0 +1,172 @@
+#pragma once
+
+#include <array>
+
+/**
+ * ParameterSnapshot - Flat copy of every plugin parameter value
+ *
+ * Parameter IDs are listed once here, in the same order as the Index enum.
+ * The processor resolves the APVTS value pointers for these IDs a single time
+ * at construction, copies them into a snapshot at the start of each block and
+ * only forwards the entries that differ from the previous block to the voices.
+ */
+struct ParameterSnapshot
+{
+    enum Index
+    {
+        VoiceMode = 0,
+        UnisonDetune,
+        Polyphony,
+        UnisonVoices,
+
+        // Oscillators (same layout repeated for each oscillator)
+        Osc1Enabled,
+        Osc1Waveform,
+        Osc1Gain,
+        Osc1Detune,
+        Osc1Octave,
+        Osc1PW,
+        Osc1Drive,
+        Osc1Engine,
+
+        Osc2Enabled,
+        Osc2Waveform,
+        Osc2Gain,
+        Osc2Detune,
+        Osc2Octave,
+        Osc2PW,
+        Osc2Drive,
+        Osc2Engine,
+
+        Osc3Enabled,
+        Osc3Waveform,
+        Osc3Gain,
+        Osc3Detune,
+        Osc3Octave,
+        Osc3PW,
+        Osc3Drive,
+        Osc3Engine,
+
+        // Envelope
+        Attack,
+        Decay,
+        Sustain,
+        Release,
+
+        // Noise
+        NoiseEnabled,
+        NoiseType,
+        NoiseGain,
+
+        MasterVolume,
+
+        // Filter
+        FilterMode,
+        FilterCutoff,
+        FilterResonance,
+        FilterModel,
+
+        // LFOs
+        LFO1Waveform,
+        LFO1Rate,
+        LFO1Depth,
+        LFO1Destination,
+        LFO1RateMode,
+        LFO1SyncDiv,
+        LFO1Mode,
+
+        LFO2Waveform,
+        LFO2Rate,
+        LFO2Depth,
+        LFO2Destination,
+        LFO2RateMode,
+        LFO2SyncDiv,
+        LFO2Mode,
+
+        // Modulation matrix (same layout repeated for each user slot)
+        Mod1Source,
+        Mod1Destination,
+        Mod1Amount,
+
+        Mod2Source,
+        Mod2Destination,
+        Mod2Amount,
+
+        Mod3Source,
+        Mod3Destination,
+        Mod3Amount,
+
+        Mod4Source,
+        Mod4Destination,
+        Mod4Amount,
+
+        ModControlRate,
+
+        // Oversampling (realtime playback / offline rendering)
+        Oversampling,
+        RenderOversampling,
+
+        // Seeded random sources, restarted when a render starts
+        DeterministicRender,
+
+        NumParameters
+    };
+
+    static constexpr const char* parameterIDs[NumParameters] =
+    {
+        "voiceMode",
+        "unisonDetune",
+        "polyphony",
+        "unisonVoices",
+
+        "osc1Enabled", "osc1Waveform", "osc1Gain", "osc1Detune", "osc1Octave", "osc1PW", "osc1Drive", "osc1Engine",
+        "osc2Enabled", "osc2Waveform", "osc2Gain", "osc2Detune", "osc2Octave", "osc2PW", "osc2Drive", "osc2Engine",
+        "osc3Enabled", "osc3Waveform", "osc3Gain", "osc3Detune", "osc3Octave", "osc3PW", "osc3Drive", "osc3Engine",
+
+        "attack", "decay", "sustain", "release",
+
+        "noiseEnabled", "noiseType", "noiseGain",
+
+        "masterVolume",
+
+        "filterMode", "filterCutoff", "filterResonance", "filterModel",
+
+        "lfo1Waveform", "lfo1Rate", "lfo1Depth", "lfo1Destination", "lfo1RateMode", "lfo1SyncDiv", "lfo1Mode",
+        "lfo2Waveform", "lfo2Rate", "lfo2Depth", "lfo2Destination", "lfo2RateMode", "lfo2SyncDiv", "lfo2Mode",
+
+        "mod1Source", "mod1Destination", "mod1Amount",
+        "mod2Source", "mod2Destination", "mod2Amount",
+        "mod3Source", "mod3Destination", "mod3Amount",
+        "mod4Source", "mod4Destination", "mod4Amount",
+        "modControlRate",
+
+        "oversampling", "renderOversampling",
+
+        "deterministicRender"
+    };
+
+    /**
+     * Index of an oscillator parameter for any oscillator
+     * @param oscIndex Oscillator (0-2)
+     * @param osc1Param The parameter's Osc1 index (e.g. Osc1Gain)
+     */
+    static constexpr Index oscillatorParameter(int oscIndex, Index osc1Param)
+    {
+        return static_cast<Index>(osc1Param + oscIndex * (Osc2Enabled - Osc1Enabled));
+    }
+
+    /**
+     * Index of a modulation slot parameter for any user slot
+     * @param slotIndex User slot (0-3)
+     * @param mod1Param The parameter's Mod1 index (e.g. Mod1Amount)
+     */
+    static constexpr Index modulationParameter(int slotIndex, Index mod1Param)
+    {
+        return static_cast<Index>(mod1Param + slotIndex * (Mod2Source - Mod1Source));
+    }
+
+    float operator[](int index) const { return values[index]; }
+    float& operator[](int index) { return values[index]; }
+
+    std::array<float, NumParameters> values {};
+};
@@ -860,6 +860,7 @@ CLEMMY3AudioProcessorEditor::CLEMMY3AudioProcessorEditor(CLEMMY3AudioProcessor&
 
     // ========== MIDI KEYBOARD ==========
     addAndMakeVisible(midiKeyboard);
+    audioProcessor.setVirtualKeyboardActive(true);
 
     // Enable keyboard focus so computer keyboard works
     setWantsKeyboardFocus(true);
@@ -868,6 +869,7 @@ CLEMMY3AudioProcessorEditor::CLEMMY3AudioProcessorEditor(CLEMMY3AudioProcessor&
 CLEMMY3AudioProcessorEditor::~CLEMMY3AudioProcessorEditor()
 {
     audioProcessor.parameters.removeParameterListener("voiceMode", this);
+    audioProcessor.setVirtualKeyboardActive(false);
 }
 
 //==============================================================================
@@ -1,5 +1,6 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "RealtimeCheck.h"
 
 //==============================================================================
 CLEMMY3AudioProcessor::CLEMMY3AudioProcessor()
@@ -16,8 +17,18 @@ CLEMMY3AudioProcessor::CLEMMY3AudioProcessor()
     :
 #endif
       parameters(*this, nullptr, "PARAMETERS", createParameterLayout()),
-      presetManager(parameters)
+      presetManager(parameters, presetQueue)
 {
+    // Resolve parameter value pointers once; processBlock reads them through this table
+    for (int i = 0; i < ParameterSnapshot::NumParameters; ++i)
+    {
+        parameterValues[i] = parameters.getRawParameterValue(ParameterSnapshot::parameterIDs[i]);
+        jassert(parameterValues[i] != nullptr);
+    }
+
+    // Each instance gets its own seed; setStateInformation restores a saved one
+    randomSeed = static_cast<uint32_t>(juce::Random::getSystemRandom().nextInt());
+    voiceManager.setRandomSeed(randomSeed);
 }
 
 CLEMMY3AudioProcessor::~CLEMMY3AudioProcessor()
@@ -42,6 +53,13 @@ juce::AudioProcessorValueTreeState::ParameterLayout CLEMMY3AudioProcessor::creat
         juce::StringArray{"5 ct", "7 ct", "10 ct", "12 ct", "15 ct", "20 ct", "25 ct"},
         2));  // Default: "10 ct" (index 2)
 
+    // Voice counts (the voice pool is allocated for VoiceManager::MAX_VOICES in prepareToPlay)
+    params.push_back(std::make_unique<juce::AudioParameterInt>(
+        "polyphony", "Polyphony", 1, VoiceManager::MAX_VOICES, VoiceManager::DEFAULT_VOICES));
+
+    params.push_back(std::make_unique<juce::AudioParameterInt>(
+        "unisonVoices", "Unison Voices", 1, 16, VoiceManager::DEFAULT_VOICES));
+
     // ==================== OSCILLATOR 1 PARAMETERS ====================
     params.push_back(std::make_unique<juce::AudioParameterBool>(
         "osc1Enabled", "Osc 1 Enabled", true));
@@ -75,6 +93,11 @@ juce::AudioProcessorValueTreeState::ParameterLayout CLEMMY3AudioProcessor::creat
         juce::NormalisableRange<float>(1.0f, 10.0f, 0.01f, 0.5f),
         1.0f));  // Default: 1.0 (no saturation)
 
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "osc1Engine", "Osc 1 Engine",
+        juce::StringArray{"PolyBLEP", "Wavetable"},
+        0));  // Default: PolyBLEP
+
     // ==================== OSCILLATOR 2 PARAMETERS ====================
     params.push_back(std::make_unique<juce::AudioParameterBool>(
         "osc2Enabled", "Osc 2 Enabled", true));
@@ -108,6 +131,11 @@ juce::AudioProcessorValueTreeState::ParameterLayout CLEMMY3AudioProcessor::creat
         juce::NormalisableRange<float>(1.0f, 10.0f, 0.01f, 0.5f),
         1.0f));  // Default: 1.0 (no saturation)
 
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "osc2Engine", "Osc 2 Engine",
+        juce::StringArray{"PolyBLEP", "Wavetable"},
+        0));  // Default: PolyBLEP
+
     // ==================== OSCILLATOR 3 PARAMETERS ====================
     params.push_back(std::make_unique<juce::AudioParameterBool>(
         "osc3Enabled", "Osc 3 Enabled", true));
@@ -141,6 +169,11 @@ juce::AudioProcessorValueTreeState::ParameterLayout CLEMMY3AudioProcessor::creat
         juce::NormalisableRange<float>(1.0f, 10.0f, 0.01f, 0.5f),
         1.0f));  // Default: 1.0 (no saturation)
 
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "osc3Engine", "Osc 3 Engine",
+        juce::StringArray{"PolyBLEP", "Wavetable"},
+        0));  // Default: PolyBLEP
+
     // ==================== ADSR ENVELOPE PARAMETERS ====================
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         "attack", "Attack",
@@ -201,6 +234,11 @@ juce::AudioProcessorValueTreeState::ParameterLayout CLEMMY3AudioProcessor::creat
         juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f),
         0.0f));  // Default: 0% (no resonance)
 
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "filterModel", "Filter Model",
+        juce::StringArray{"Classic", "Zero Delay"},
+        0));  // Default: Classic (unit-delay ladder)
+
     // ==================== LFO 1 PARAMETERS ====================
     params.push_back(std::make_unique<juce::AudioParameterChoice>(
         "lfo1Waveform", "LFO 1 Waveform",
@@ -232,6 +270,11 @@ juce::AudioProcessorValueTreeState::ParameterLayout CLEMMY3AudioProcessor::creat
         juce::StringArray{"1/128", "1/64", "1/32", "1/16", "1/8", "1/4", "1/2", "1/1", "2/1", "4/1"},
         5));  // Default: 1/4 (index 5)
 
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "lfo1Mode", "LFO 1 Mode",
+        juce::StringArray{"Per Voice", "Global"},
+        0));  // Default: Per Voice (retriggered on each note)
+
     // ==================== LFO 2 PARAMETERS ====================
     params.push_back(std::make_unique<juce::AudioParameterChoice>(
         "lfo2Waveform", "LFO 2 Waveform",
@@ -263,6 +306,58 @@ juce::AudioProcessorValueTreeState::ParameterLayout CLEMMY3AudioProcessor::creat
         juce::StringArray{"1/128", "1/64", "1/32", "1/16", "1/8", "1/4", "1/2", "1/1", "2/1", "4/1"},
         5));  // Default: 1/4 (index 5)
 
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "lfo2Mode", "LFO 2 Mode",
+        juce::StringArray{"Per Voice", "Global"},
+        0));  // Default: Per Voice (retriggered on each note)
+
+    // ==================== MODULATION MATRIX PARAMETERS ====================
+    // Free routings on top of the LFO destinations (choice order = ModulationMatrix enums)
+    for (int slot = 1; slot <= 4; ++slot)
+    {
+        const juce::String id = "mod" + juce::String(slot);
+        const juce::String name = "Mod " + juce::String(slot);
+
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(
+            id + "Source", name + " Source",
+            juce::StringArray{"None", "LFO 1", "LFO 2", "Envelope", "Velocity", "Note", "Mod Wheel"},
+            0));  // Default: None
+
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(
+            id + "Destination", name + " Destination",
+            juce::StringArray{"None", "Filter Cutoff", "Pitch", "PWM", "Filter Res", "Volume"},
+            0));  // Default: None
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            id + "Amount", name + " Amount",
+            juce::NormalisableRange<float>(-1.0f, 1.0f, 0.01f),
+            0.0f));  // Default: 0 (off)
+    }
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "modControlRate", "Modulation Control Rate",
+        juce::StringArray{"1 sample", "8 samples", "16 samples", "32 samples"},
+        2));  // Default: every 16 samples
+
+    // ==================== OVERSAMPLING PARAMETERS ====================
+    // Oscillators, drive and filter run at 2x/4x the host rate (choice index n = 2^n)
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "oversampling", "Oversampling",
+        juce::StringArray{"Off", "2x", "4x"},
+        0));  // Default: Off
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        "renderOversampling", "Render Oversampling",
+        juce::StringArray{"Off", "2x", "4x"},
+        0));  // Default: Off (used instead of Oversampling when the host renders offline)
+
+    // ==================== DETERMINISTIC RENDER ====================
+    // Noise, unison phases and sample & hold restart from the instance seed
+    // whenever playback starts, so repeated renders are bit-identical
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        "deterministicRender", "Deterministic Render",
+        false));  // Default: Off (random sources run on freely)
+
     return { params.begin(), params.end() };
 }
 
@@ -330,12 +425,46 @@ void CLEMMY3AudioProcessor::changeProgramName(int, const juce::String&)
 //==============================================================================
 void CLEMMY3AudioProcessor::prepareToPlay(double sampleRate, int)
 {
-    // Initialize voice manager with sample rate
-    voiceManager.setSampleRate(sampleRate);
+    // Allocate the full voice pool here so polyphony can change later without allocating
+    voiceManager.prepare(sampleRate, VoiceManager::MAX_VOICES);
+
+    // Audio is stopped here, so worker threads can be (re)created safely.
+    // Leave one hardware thread for the audio thread itself.
+    const int maxRenderThreads = juce::jmax(0, juce::SystemStats::getNumCpus() - 1);
+    voiceManager.setNumRenderThreads(juce::jmin(numRenderThreads.load(), maxRenderThreads));
+
+    // Push every parameter (and the tempo) on the next block, not just the changed ones
+    parametersNeedFullUpdate = true;
+    appliedBPM = 0.0f;
+
+    presetFade = PresetFade::None;
+    presetFadeGain = 1.0f;
+    presetFadeStep = static_cast<float>(1.0 / (PRESET_FADE_SECONDS * sampleRate));
+
+    // A render usually follows: restart the random sources on the first block
+    randomStateNeedsReset = true;
+
+    // Room for the MIDI merged in processBlock, so the audio thread doesn't allocate
+    keyboardMidi.ensureSize(MIDI_BUFFER_BYTES);
+    combinedMidi.ensureSize(MIDI_BUFFER_BYTES);
+}
+
+void CLEMMY3AudioProcessor::setVirtualKeyboardActive(bool active)
+{
+    if (!active)
+    {
+        // Release keys still held; processBlock picks up their note-offs once more
+        keyboardState.allNotesOff(0);
+        virtualKeyboardNeedsFlush = true;
+    }
+
+    virtualKeyboardActive = active;
 }
 
 void CLEMMY3AudioProcessor::releaseResources()
 {
+    // Don't keep render workers around while not playing
+    voiceManager.setNumRenderThreads(0);
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -362,6 +491,7 @@ bool CLEMMY3AudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) c
 void CLEMMY3AudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+    RealtimeCheck::ScopedAudioThread audioThread;  // Counts allocations/locks in CLEMMY3_RT_CHECK builds
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -369,141 +499,60 @@ void CLEMMY3AudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce:
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    // Merge MIDI from virtual keyboard with incoming MIDI
-    juce::MidiBuffer virtualKeyboardMidi;
-    keyboardState.processNextMidiBuffer(virtualKeyboardMidi, 0, buffer.getNumSamples(), true);
-
-    // Combine both MIDI sources
-    juce::MidiBuffer combinedMidi;
-    combinedMidi.addEvents(midiMessages, 0, buffer.getNumSamples(), 0);
-    combinedMidi.addEvents(virtualKeyboardMidi, 0, buffer.getNumSamples(), 0);
-
-    // Get current parameter values
-    int voiceModeIndex = parameters.getRawParameterValue("voiceMode")->load();
-
-    // Map unison detune choice index to actual cent values
-    int unisonDetuneIndex = parameters.getRawParameterValue("unisonDetune")->load();
-    const float unisonDetuneValues[] = {5.0f, 7.0f, 10.0f, 12.0f, 15.0f, 20.0f, 25.0f};
-    float unisonDetune = unisonDetuneValues[unisonDetuneIndex];
-
-    // Oscillator 1 parameters
-    bool osc1Enabled = parameters.getRawParameterValue("osc1Enabled")->load() > 0.5f;
-    int osc1Waveform = parameters.getRawParameterValue("osc1Waveform")->load();
-    float osc1Gain = parameters.getRawParameterValue("osc1Gain")->load();
-    float osc1Detune = parameters.getRawParameterValue("osc1Detune")->load();
-    int osc1Octave = static_cast<int>(parameters.getRawParameterValue("osc1Octave")->load());
-    float osc1PW = parameters.getRawParameterValue("osc1PW")->load();
-    float osc1Drive = parameters.getRawParameterValue("osc1Drive")->load();
-
-    // Oscillator 2 parameters
-    bool osc2Enabled = parameters.getRawParameterValue("osc2Enabled")->load() > 0.5f;
-    int osc2Waveform = parameters.getRawParameterValue("osc2Waveform")->load();
-    float osc2Gain = parameters.getRawParameterValue("osc2Gain")->load();
-    float osc2Detune = parameters.getRawParameterValue("osc2Detune")->load();
-    int osc2Octave = static_cast<int>(parameters.getRawParameterValue("osc2Octave")->load());
-    float osc2PW = parameters.getRawParameterValue("osc2PW")->load();
-    float osc2Drive = parameters.getRawParameterValue("osc2Drive")->load();
-
-    // Oscillator 3 parameters
-    bool osc3Enabled = parameters.getRawParameterValue("osc3Enabled")->load() > 0.5f;
-    int osc3Waveform = parameters.getRawParameterValue("osc3Waveform")->load();
-    float osc3Gain = parameters.getRawParameterValue("osc3Gain")->load();
-    float osc3Detune = parameters.getRawParameterValue("osc3Detune")->load();
-    int osc3Octave = static_cast<int>(parameters.getRawParameterValue("osc3Octave")->load());
-    float osc3PW = parameters.getRawParameterValue("osc3PW")->load();
-    float osc3Drive = parameters.getRawParameterValue("osc3Drive")->load();
-
-    // ADSR Envelope parameters
-    float attack = parameters.getRawParameterValue("attack")->load();
-    float decay = parameters.getRawParameterValue("decay")->load();
-    float sustain = parameters.getRawParameterValue("sustain")->load();
-    float release = parameters.getRawParameterValue("release")->load();
-
-    // Noise parameters
-    bool noiseEnabled = parameters.getRawParameterValue("noiseEnabled")->load() > 0.5f;
-    int noiseTypeIndex = parameters.getRawParameterValue("noiseType")->load();
-    float noiseGain = parameters.getRawParameterValue("noiseGain")->load();
-
-    // Filter parameters
-    int filterModeIndex = parameters.getRawParameterValue("filterMode")->load();
-    float filterCutoff = parameters.getRawParameterValue("filterCutoff")->load();
-    float filterResonance = parameters.getRawParameterValue("filterResonance")->load();
+    // Merge MIDI from the virtual keyboard with incoming MIDI. The keyboard is
+    // only polled while the editor shows it (and once more after it closes,
+    // for the note-offs of keys still held); both buffers are reserved in
+    // prepareToPlay, so merging doesn't allocate.
+    const juce::MidiBuffer* midi = &midiMessages;
 
-    // Update voice manager mode and unison detune
-    voiceManager.setVoiceMode(static_cast<VoiceManager::VoiceMode>(voiceModeIndex));
-    voiceManager.setUnisonDetune(unisonDetune);
-
-    // Broadcast oscillator 1 parameters to all voices
-    voiceManager.setOscillatorEnabled(0, osc1Enabled);
-    voiceManager.setOscillatorWaveform(0, static_cast<Oscillator::Waveform>(osc1Waveform));
-    voiceManager.setOscillatorGain(0, osc1Gain);
-    voiceManager.setOscillatorDetune(0, osc1Detune);
-    voiceManager.setOscillatorOctave(0, osc1Octave);
-    voiceManager.setOscillatorPulseWidth(0, osc1PW);
-    voiceManager.setOscillatorDrive(0, osc1Drive);
-
-    // Broadcast oscillator 2 parameters to all voices
-    voiceManager.setOscillatorEnabled(1, osc2Enabled);
-    voiceManager.setOscillatorWaveform(1, static_cast<Oscillator::Waveform>(osc2Waveform));
-    voiceManager.setOscillatorGain(1, osc2Gain);
-    voiceManager.setOscillatorDetune(1, osc2Detune);
-    voiceManager.setOscillatorOctave(1, osc2Octave);
-    voiceManager.setOscillatorPulseWidth(1, osc2PW);
-    voiceManager.setOscillatorDrive(1, osc2Drive);
-
-    // Broadcast oscillator 3 parameters to all voices
-    voiceManager.setOscillatorEnabled(2, osc3Enabled);
-    voiceManager.setOscillatorWaveform(2, static_cast<Oscillator::Waveform>(osc3Waveform));
-    voiceManager.setOscillatorGain(2, osc3Gain);
-    voiceManager.setOscillatorDetune(2, osc3Detune);
-    voiceManager.setOscillatorOctave(2, osc3Octave);
-    voiceManager.setOscillatorPulseWidth(2, osc3PW);
-    voiceManager.setOscillatorDrive(2, osc3Drive);
+    if (virtualKeyboardActive.load() || virtualKeyboardNeedsFlush.exchange(false))
+    {
+        keyboardMidi.clear();
+        keyboardState.processNextMidiBuffer(keyboardMidi, 0, buffer.getNumSamples(), true);
 
-    // Broadcast envelope parameters
-    voiceManager.setEnvelopeParameters(attack, decay, sustain, release);
+        if (!keyboardMidi.isEmpty())
+        {
+            combinedMidi.clear();
+            combinedMidi.addEvents(midiMessages, 0, buffer.getNumSamples(), 0);
+            combinedMidi.addEvents(keyboardMidi, 0, buffer.getNumSamples(), 0);
+            midi = &combinedMidi;
+        }
+    }
 
-    // Broadcast noise parameters
-    voiceManager.setNoiseEnabled(noiseEnabled);
-    voiceManager.setNoiseType(static_cast<NoiseGenerator::NoiseType>(noiseTypeIndex));
-    voiceManager.setNoiseGain(noiseGain);
+    // Copy parameter values. A preset change arrives whole through the preset
+    // queue and is played until the APVTS holds all of its values. The applied
+    // generation is read before the values, so a block that reads them while
+    // replaceState() is halfway through always finds that preset queued.
+    const uint32_t appliedPresetGeneration = presetQueue.getAppliedGeneration();
+    ParameterSnapshot snapshot = readParameters();
 
-    // Broadcast filter parameters
-    voiceManager.setFilterMode(static_cast<MoogFilter::Mode>(filterModeIndex));
-    voiceManager.setFilterCutoff(filterCutoff);
-    voiceManager.setFilterResonance(filterResonance);
-
-    // LFO parameters
-    int lfo1WaveformIndex = parameters.getRawParameterValue("lfo1Waveform")->load();
-    float lfo1Rate = parameters.getRawParameterValue("lfo1Rate")->load();
-    float lfo1Depth = parameters.getRawParameterValue("lfo1Depth")->load();
-    int lfo1Destination = parameters.getRawParameterValue("lfo1Destination")->load();
-    int lfo1RateModeIndex = parameters.getRawParameterValue("lfo1RateMode")->load();
-    int lfo1SyncDivIndex = parameters.getRawParameterValue("lfo1SyncDiv")->load();
-
-    int lfo2WaveformIndex = parameters.getRawParameterValue("lfo2Waveform")->load();
-    float lfo2Rate = parameters.getRawParameterValue("lfo2Rate")->load();
-    float lfo2Depth = parameters.getRawParameterValue("lfo2Depth")->load();
-    int lfo2Destination = parameters.getRawParameterValue("lfo2Destination")->load();
-    int lfo2RateModeIndex = parameters.getRawParameterValue("lfo2RateMode")->load();
-    int lfo2SyncDivIndex = parameters.getRawParameterValue("lfo2SyncDiv")->load();
+    if (presetQueue.popNewest(heldPreset))
+    {
+        presetHeld = true;
 
-    // Broadcast LFO parameters
-    voiceManager.setLFO1Waveform(static_cast<LFO::Waveform>(lfo1WaveformIndex));
-    voiceManager.setLFO1Rate(lfo1Rate);
-    voiceManager.setLFO1Depth(lfo1Depth);
-    voiceManager.setLFO1Destination(lfo1Destination);
-    voiceManager.setLFO1RateMode(static_cast<LFO::RateMode>(lfo1RateModeIndex));
-    voiceManager.setLFO1SyncDivision(static_cast<LFO::SyncDivision>(lfo1SyncDivIndex));
-
-    voiceManager.setLFO2Waveform(static_cast<LFO::Waveform>(lfo2WaveformIndex));
-    voiceManager.setLFO2Rate(lfo2Rate);
-    voiceManager.setLFO2Depth(lfo2Depth);
-    voiceManager.setLFO2Destination(lfo2Destination);
-    voiceManager.setLFO2RateMode(static_cast<LFO::RateMode>(lfo2RateModeIndex));
-    voiceManager.setLFO2SyncDivision(static_cast<LFO::SyncDivision>(lfo2SyncDivIndex));
-
-    // Get current BPM from host
+        // Sounding voices fade out before the switch and back in after it
+        if (voiceManager.getNumActiveVoices() > 0)
+            presetFade = PresetFade::Out;
+    }
+
+    if (presetHeld)
+    {
+        if (heldPreset.generation <= appliedPresetGeneration)
+            presetHeld = false;
+        else
+            snapshot = heldPreset.parameters;
+    }
+
+    // Forward only the values that changed to the voices (none while fading
+    // out: the old preset keeps playing until the output is silent)
+    if (presetFade != PresetFade::Out)
+        applyParameterChanges(snapshot);
+
+    const ParameterSnapshot& blockParameters = presetFade == PresetFade::Out ? appliedParameters : snapshot;
+
+    // Get current BPM and transport position from host
+    juce::Optional<double> ppqPosition;
+    bool isPlaying = false;
     auto playHead = getPlayHead();
     if (playHead != nullptr)
     {
@@ -513,46 +562,333 @@ void CLEMMY3AudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce:
             {
                 currentBPM = static_cast<float>(*positionInfo->getBpm());
             }
+
+            if (positionInfo->getIsPlaying())
+            {
+                isPlaying = true;
+                ppqPosition = positionInfo->getPpqPosition();
+            }
         }
     }
 
-    // Update LFO BPM for all voices
-    voiceManager.setLFO1BPM(currentBPM);
-    voiceManager.setLFO2BPM(currentBPM);
+    // Deterministic render: start from silence with the instance seed after
+    // prepareToPlay, on state load and whenever the transport starts
+    const bool transportStarted = isPlaying && ! wasPlaying;
+    wasPlaying = isPlaying;
+
+    if (randomStateNeedsReset.exchange(false) || transportStarted)
+    {
+        if (blockParameters[ParameterSnapshot::DeterministicRender] >= 1.0f)
+        {
+            voiceManager.allSoundOff();
+            voiceManager.setRandomSeed(randomSeed);
+        }
+    }
 
-    // Process MIDI messages (from both sources)
-    for (const auto metadata : combinedMidi)
+    // Update LFO BPM for all voices when the host tempo changes
+    if (! juce::exactlyEqual(currentBPM, appliedBPM))
     {
-        auto message = metadata.getMessage();
+        voiceManager.setLFO1BPM(currentBPM);
+        voiceManager.setLFO2BPM(currentBPM);
+        appliedBPM = currentBPM;
+    }
+
+    // Tempo-synced LFOs follow the transport while the host plays (relocked
+    // every block, so tempo ramps can't make them drift) and free-run otherwise
+    if (ppqPosition.hasValue())
+        voiceManager.setTransportPosition(*ppqPosition, currentBPM);
+    else
+        voiceManager.clearTransportPosition();
+
+    float masterVolume = blockParameters[ParameterSnapshot::MasterVolume];
+
+    if (totalNumOutputChannels == 0)
+        return;
 
-        if (message.isNoteOn())
+    const int numSamples = buffer.getNumSamples();
+    float* output = buffer.getWritePointer(0);
+
+    // A fade out that ends inside this block switches to the new preset at
+    // that sample, so the fade in starts right away
+    const int fadeOutSamples = presetFade == PresetFade::Out ? getPresetFadeOutSamples() : numSamples + 1;
+    const int presetSwitchSample = juce::jmin(fadeOutSamples, numSamples);
+    bool presetSwitchPending = fadeOutSamples <= numSamples;
+
+    // Render into the first channel, splitting the block at each MIDI event
+    // so notes start and stop on the exact sample the host scheduled them
+    int currentSample = 0;
+
+    auto renderUpTo = [&](int endSample)
+    {
+        if (endSample > currentSample)
         {
-            int midiNote = message.getNoteNumber();
-            float velocity = message.getFloatVelocity();
-            voiceManager.noteOn(midiNote, velocity);
+            voiceManager.renderBlock(output, currentSample, endSample - currentSample);
+            currentSample = endSample;
         }
-        else if (message.isNoteOff())
+    };
+
+    auto switchPresetIfDue = [&](int nextSample)
+    {
+        if (presetSwitchPending && presetSwitchSample <= nextSample)
         {
-            int midiNote = message.getNoteNumber();
-            voiceManager.noteOff(midiNote);
+            renderUpTo(presetSwitchSample);
+            applyParameterChanges(snapshot);
+            presetSwitchPending = false;
         }
+    };
+
+    for (const auto metadata : *midi)
+    {
+        const int eventSample = juce::jlimit(currentSample, numSamples, metadata.samplePosition);
+
+        switchPresetIfDue(eventSample);
+        renderUpTo(eventSample);
+        handleMidiMessage(metadata.getMessage());
     }
 
-    // Read master volume parameter
-    float masterVolume = parameters.getRawParameterValue("masterVolume")->load();
+    switchPresetIfDue(numSamples);
+    renderUpTo(numSamples);
+
+    // Master volume (the new preset's from the switch on), then the fade
+    juce::FloatVectorOperations::multiply(output, 0.3f * masterVolume, presetSwitchSample);
+    juce::FloatVectorOperations::multiply(output + presetSwitchSample,
+                                          0.3f * snapshot[ParameterSnapshot::MasterVolume],
+                                          numSamples - presetSwitchSample);
 
-    // Generate audio samples from voice manager
-    for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+    if (presetFade != PresetFade::None)
+        applyPresetFade(output, numSamples);
+
+    // Copy to the remaining channels
+    for (int channel = 1; channel < totalNumOutputChannels; ++channel)
+    {
+        buffer.copyFrom(channel, 0, buffer, 0, 0, numSamples);
+    }
+}
+
+void CLEMMY3AudioProcessor::handleMidiMessage(const juce::MidiMessage& message)
+{
+    if (message.isNoteOn())
+    {
+        int midiNote = message.getNoteNumber();
+        float velocity = message.getFloatVelocity();
+        voiceManager.noteOn(midiNote, velocity);
+    }
+    else if (message.isNoteOff())
+    {
+        int midiNote = message.getNoteNumber();
+        voiceManager.noteOff(midiNote);
+    }
+    else if (message.isController() && message.getControllerNumber() == 1)
+    {
+        // Mod wheel is a modulation matrix source
+        voiceManager.setModWheel(message.getControllerValue() / 127.0f);
+    }
+}
+
+int CLEMMY3AudioProcessor::getPresetFadeOutSamples() const
+{
+    // Same steps as applyPresetFade, so the switch lands on its first silent sample
+    float gain = presetFadeGain;
+    int numSamples = 0;
+
+    while (gain > 0.0f)
+    {
+        gain = juce::jmax(0.0f, gain - presetFadeStep);
+        ++numSamples;
+    }
+
+    return numSamples;
+}
+
+void CLEMMY3AudioProcessor::applyPresetFade(float* output, int numSamples)
+{
+    for (int i = 0; i < numSamples; ++i)
     {
-        // Get mixed output from all active voices
-        float output = voiceManager.processSample() * 0.3f * masterVolume;
+        if (presetFade == PresetFade::Out)
+        {
+            presetFadeGain = juce::jmax(0.0f, presetFadeGain - presetFadeStep);
 
-        // Output to all channels
-        for (int channel = 0; channel < totalNumOutputChannels; ++channel)
+            // Silent: processBlock switched to the new preset after this sample
+            if (presetFadeGain <= 0.0f)
+                presetFade = PresetFade::In;
+        }
+        else if (presetFade == PresetFade::In)
         {
-            buffer.setSample(channel, sample, output);
+            presetFadeGain = juce::jmin(1.0f, presetFadeGain + presetFadeStep);
+
+            if (presetFadeGain >= 1.0f)
+                presetFade = PresetFade::None;
         }
+
+        output[i] *= presetFadeGain;
+    }
+}
+
+ParameterSnapshot CLEMMY3AudioProcessor::readParameters() const
+{
+    ParameterSnapshot snapshot;
+
+    for (int i = 0; i < ParameterSnapshot::NumParameters; ++i)
+    {
+        snapshot[i] = parameterValues[i]->load();
     }
+
+    return snapshot;
+}
+
+void CLEMMY3AudioProcessor::applyParameterChanges(const ParameterSnapshot& snapshot)
+{
+    using P = ParameterSnapshot;
+
+    // Only forward values that differ from the last applied snapshot
+    // (everything on the first block after prepareToPlay)
+    auto changed = [&](int index)
+    {
+        return parametersNeedFullUpdate || ! juce::exactlyEqual(snapshot[index], appliedParameters[index]);
+    };
+
+    // Update voice manager mode and unison detune
+    if (changed(P::VoiceMode))
+    {
+        voiceManager.setVoiceMode(static_cast<VoiceManager::VoiceMode>(static_cast<int>(snapshot[P::VoiceMode])));
+    }
+
+    if (changed(P::UnisonDetune))
+    {
+        // Map unison detune choice index to actual cent values
+        const float unisonDetuneValues[] = {5.0f, 7.0f, 10.0f, 12.0f, 15.0f, 20.0f, 25.0f};
+        voiceManager.setUnisonDetune(unisonDetuneValues[static_cast<int>(snapshot[P::UnisonDetune])]);
+    }
+
+    if (changed(P::Polyphony))
+    {
+        voiceManager.setPolyphony(static_cast<int>(snapshot[P::Polyphony]));
+    }
+
+    if (changed(P::UnisonVoices))
+    {
+        voiceManager.setUnisonVoices(static_cast<int>(snapshot[P::UnisonVoices]));
+    }
+
+    // Broadcast oscillator parameters to all voices
+    for (int osc = 0; osc < Voice::NUM_OSCILLATORS; ++osc)
+    {
+        const auto enabled = P::oscillatorParameter(osc, P::Osc1Enabled);
+        const auto waveform = P::oscillatorParameter(osc, P::Osc1Waveform);
+        const auto gain = P::oscillatorParameter(osc, P::Osc1Gain);
+        const auto detune = P::oscillatorParameter(osc, P::Osc1Detune);
+        const auto octave = P::oscillatorParameter(osc, P::Osc1Octave);
+        const auto pulseWidth = P::oscillatorParameter(osc, P::Osc1PW);
+        const auto drive = P::oscillatorParameter(osc, P::Osc1Drive);
+        const auto engine = P::oscillatorParameter(osc, P::Osc1Engine);
+
+        if (changed(enabled))
+            voiceManager.setOscillatorEnabled(osc, snapshot[enabled] > 0.5f);
+        if (changed(waveform))
+            voiceManager.setOscillatorWaveform(osc, static_cast<Oscillator::Waveform>(static_cast<int>(snapshot[waveform])));
+        if (changed(gain))
+            voiceManager.setOscillatorGain(osc, snapshot[gain]);
+        if (changed(detune))
+            voiceManager.setOscillatorDetune(osc, snapshot[detune]);
+        if (changed(octave))
+            voiceManager.setOscillatorOctave(osc, static_cast<int>(snapshot[octave]));
+        if (changed(pulseWidth))
+            voiceManager.setOscillatorPulseWidth(osc, snapshot[pulseWidth]);
+        if (changed(drive))
+            voiceManager.setOscillatorDrive(osc, snapshot[drive]);
+        if (changed(engine))
+            voiceManager.setOscillatorEngine(osc, static_cast<Oscillator::Engine>(static_cast<int>(snapshot[engine])));
+    }
+
+    // Broadcast envelope parameters
+    if (changed(P::Attack) || changed(P::Decay) || changed(P::Sustain) || changed(P::Release))
+    {
+        voiceManager.setEnvelopeParameters(snapshot[P::Attack], snapshot[P::Decay],
+                                           snapshot[P::Sustain], snapshot[P::Release]);
+    }
+
+    // Broadcast noise parameters
+    if (changed(P::NoiseEnabled))
+        voiceManager.setNoiseEnabled(snapshot[P::NoiseEnabled] > 0.5f);
+    if (changed(P::NoiseType))
+        voiceManager.setNoiseType(static_cast<NoiseGenerator::NoiseType>(static_cast<int>(snapshot[P::NoiseType])));
+    if (changed(P::NoiseGain))
+        voiceManager.setNoiseGain(snapshot[P::NoiseGain]);
+
+    // Broadcast filter parameters
+    if (changed(P::FilterMode))
+        voiceManager.setFilterMode(static_cast<MoogFilter::Mode>(static_cast<int>(snapshot[P::FilterMode])));
+    if (changed(P::FilterCutoff))
+        voiceManager.setFilterCutoff(snapshot[P::FilterCutoff]);
+    if (changed(P::FilterResonance))
+        voiceManager.setFilterResonance(snapshot[P::FilterResonance]);
+    if (changed(P::FilterModel))
+        voiceManager.setFilterModel(static_cast<MoogFilter::Model>(static_cast<int>(snapshot[P::FilterModel])));
+
+    // Broadcast LFO parameters
+    if (changed(P::LFO1Waveform))
+        voiceManager.setLFO1Waveform(static_cast<LFO::Waveform>(static_cast<int>(snapshot[P::LFO1Waveform])));
+    if (changed(P::LFO1Rate))
+        voiceManager.setLFO1Rate(snapshot[P::LFO1Rate]);
+    if (changed(P::LFO1Depth))
+        voiceManager.setLFO1Depth(snapshot[P::LFO1Depth]);
+    if (changed(P::LFO1Destination))
+        voiceManager.setLFO1Destination(static_cast<int>(snapshot[P::LFO1Destination]));
+    if (changed(P::LFO1RateMode))
+        voiceManager.setLFO1RateMode(static_cast<LFO::RateMode>(static_cast<int>(snapshot[P::LFO1RateMode])));
+    if (changed(P::LFO1SyncDiv))
+        voiceManager.setLFO1SyncDivision(static_cast<LFO::SyncDivision>(static_cast<int>(snapshot[P::LFO1SyncDiv])));
+    if (changed(P::LFO1Mode))
+        voiceManager.setLFO1Global(snapshot[P::LFO1Mode] >= 1.0f);
+
+    if (changed(P::LFO2Waveform))
+        voiceManager.setLFO2Waveform(static_cast<LFO::Waveform>(static_cast<int>(snapshot[P::LFO2Waveform])));
+    if (changed(P::LFO2Rate))
+        voiceManager.setLFO2Rate(snapshot[P::LFO2Rate]);
+    if (changed(P::LFO2Depth))
+        voiceManager.setLFO2Depth(snapshot[P::LFO2Depth]);
+    if (changed(P::LFO2Destination))
+        voiceManager.setLFO2Destination(static_cast<int>(snapshot[P::LFO2Destination]));
+    if (changed(P::LFO2RateMode))
+        voiceManager.setLFO2RateMode(static_cast<LFO::RateMode>(static_cast<int>(snapshot[P::LFO2RateMode])));
+    if (changed(P::LFO2SyncDiv))
+        voiceManager.setLFO2SyncDivision(static_cast<LFO::SyncDivision>(static_cast<int>(snapshot[P::LFO2SyncDiv])));
+    if (changed(P::LFO2Mode))
+        voiceManager.setLFO2Global(snapshot[P::LFO2Mode] >= 1.0f);
+
+    // Modulation matrix user slots
+    for (int slot = 0; slot < ModulationMatrix::NUM_USER_SLOTS; ++slot)
+    {
+        const auto source = P::modulationParameter(slot, P::Mod1Source);
+        const auto destination = P::modulationParameter(slot, P::Mod1Destination);
+        const auto amount = P::modulationParameter(slot, P::Mod1Amount);
+
+        if (changed(source) || changed(destination) || changed(amount))
+        {
+            voiceManager.setModulationSlot(slot,
+                                           static_cast<ModulationMatrix::Source>(static_cast<int>(snapshot[source])),
+                                           static_cast<ModulationMatrix::Destination>(static_cast<int>(snapshot[destination])),
+                                           snapshot[amount]);
+        }
+    }
+
+    if (changed(P::ModControlRate))
+    {
+        // Map control rate choice index to samples between matrix evaluations
+        const int controlIntervals[] = {1, 8, 16, 32};
+        voiceManager.setControlInterval(controlIntervals[static_cast<int>(snapshot[P::ModControlRate])]);
+    }
+
+    // Oversampling: bounces can use a higher setting than live playback.
+    // Switching only retunes the voices (buffers are sized for 4x up front).
+    const auto oversamplingChoice = isNonRealtime() ? P::RenderOversampling : P::Oversampling;
+    const int oversampling = 1 << static_cast<int>(snapshot[oversamplingChoice]);
+
+    if (oversampling != voiceManager.getOversampling())
+        voiceManager.setOversampling(oversampling);
+
+    appliedParameters = snapshot;
+    parametersNeedFullUpdate = false;
 }
 
 //==============================================================================
@@ -569,8 +905,9 @@ juce::AudioProcessorEditor* CLEMMY3AudioProcessor::createEditor()
 //==============================================================================
 void CLEMMY3AudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    // Save parameters
+    // Save parameters and the instance seed (kept out of presets)
     auto state = parameters.copyState();
+    state.setProperty(randomSeedID, static_cast<juce::int64>(randomSeed.load()), nullptr);
     std::unique_ptr<juce::XmlElement> xml(state.createXml());
     copyXmlToBinary(*xml, destData);
 }
@@ -584,7 +921,17 @@ void CLEMMY3AudioProcessor::setStateInformation(const void* data, int sizeInByte
     {
         if (xmlState->hasTagName(parameters.state.getType()))
         {
-            parameters.replaceState(juce::ValueTree::fromXml(*xmlState));
+            auto state = juce::ValueTree::fromXml(*xmlState);
+
+            // Sessions saved before the seed existed keep this instance's seed
+            if (state.hasProperty(randomSeedID))
+            {
+                randomSeed = static_cast<uint32_t>(static_cast<juce::int64>(state[randomSeedID]));
+                state.removeProperty(randomSeedID, nullptr);
+                randomStateNeedsReset = true;
+            }
+
+            parameters.replaceState(state);
         }
     }
 }
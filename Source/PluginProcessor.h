@@ -2,7 +2,9 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "DSP/VoiceManager.h"
+#include "ParameterSnapshot.h"
 #include "PresetManager.h"
+#include "PresetQueue.h"
 
 //==============================================================================
 /**
@@ -56,22 +58,79 @@ public:
     // MIDI keyboard state for virtual keyboard
     juce::MidiKeyboardState& getKeyboardState() { return keyboardState; }
 
+    // The editor reports whether its virtual keyboard exists; processBlock only polls it then
+    void setVirtualKeyboardActive(bool active);
+
     // Preset manager access
     PresetManager& getPresetManager() { return presetManager; }
 
+    // Multi-threaded voice rendering (0 = off, the default). Takes effect at the next prepareToPlay.
+    void setNumRenderThreads(int numThreads) { numRenderThreads = numThreads; }
+
+    // Seed for the random sources in Deterministic Render mode (saved with the session)
+    void setRandomSeed(uint32_t seed) { randomSeed = seed; randomStateNeedsReset = true; }
+    uint32_t getRandomSeed() const { return randomSeed; }
+
 private:
     juce::MidiKeyboardState keyboardState;
+    std::atomic<bool> virtualKeyboardActive { false };
+    std::atomic<bool> virtualKeyboardNeedsFlush { false };
+
+    // MIDI merge buffers for processBlock (reserved in prepareToPlay)
+    static constexpr size_t MIDI_BUFFER_BYTES = 16 * 1024;  // About 1800 three-byte events
+    juce::MidiBuffer keyboardMidi;
+    juce::MidiBuffer combinedMidi;
     //==============================================================================
     // Phase 3: Polyphonic voice management
     VoiceManager voiceManager;
 
-    // Phase 7: Preset management
+    // Phase 7: Preset management (presets reach the audio thread through the queue)
+    PresetQueue presetQueue;
     PresetManager presetManager;
 
+    // Preset from the queue, played until the APVTS holds all of its values
+    PresetQueue::Entry heldPreset;
+    bool presetHeld = false;
+
+    // Short fade out / fade in around a preset change while voices are sounding
+    static constexpr double PRESET_FADE_SECONDS = 0.005;
+    enum class PresetFade { None, Out, In };
+    PresetFade presetFade = PresetFade::None;
+    float presetFadeGain = 1.0f;
+    float presetFadeStep = 1.0f;  // Gain change per sample, set in prepareToPlay
+
+    // Worker threads for voice rendering, applied in prepareToPlay
+    std::atomic<int> numRenderThreads { 0 };
+
     // Host tempo for LFO MIDI sync
     float currentBPM = 120.0f;          // Tempo from host
+    float appliedBPM = 0.0f;            // Tempo last pushed to the voices
+    bool wasPlaying = false;            // Host transport state of the previous block
+
+    // Deterministic render: seed for every random source, saved with the session
+    static constexpr const char* randomSeedID = "randomSeed";
+    std::atomic<uint32_t> randomSeed { 0 };
+    std::atomic<bool> randomStateNeedsReset { true };
+
+    // Cached parameter value pointers (indexed by ParameterSnapshot::Index)
+    std::array<std::atomic<float>*, ParameterSnapshot::NumParameters> parameterValues {};
+
+    // Values last forwarded to the voice manager, for change detection
+    ParameterSnapshot appliedParameters;
+    bool parametersNeedFullUpdate = true;
 
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
+    // Apply a single MIDI event to the voice manager
+    void handleMidiMessage(const juce::MidiMessage& message);
+
+    // Parameter snapshot handling
+    ParameterSnapshot readParameters() const;
+    void applyParameterChanges(const ParameterSnapshot& snapshot);
+
+    // Advance the preset change fade over a rendered block
+    void applyPresetFade(float* output, int numSamples);
+    int getPresetFadeOutSamples() const;  // Samples until the fade out is silent
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CLEMMY3AudioProcessor)
 };
@@ -1,7 +1,7 @@
 #include "PresetManager.h"
 
-PresetManager::PresetManager(juce::AudioProcessorValueTreeState& apvts)
-    : parameters(apvts)
+PresetManager::PresetManager(juce::AudioProcessorValueTreeState& apvts, PresetQueue& queue)
+    : parameters(apvts), presetQueue(queue)
 {
     loadFactoryPresets();
     scanUserPresets();
@@ -13,11 +13,19 @@ void PresetManager::loadPreset(int presetIndex)
 {
     if (presetIndex >= 0 && presetIndex < (int)presets.size())
     {
-        parameters.replaceState(presets[presetIndex].state.createCopy());
+        applyPresetState(presets[presetIndex].state.createCopy());
         currentPresetIndex = presetIndex;
     }
 }
 
+void PresetManager::queuePreset(int presetIndex)
+{
+    if (presetIndex >= 0 && presetIndex < (int)presets.size())
+    {
+        presetQueue.push(createSnapshot(presets[presetIndex].state));
+    }
+}
+
 void PresetManager::loadNextPreset()
 {
     int nextIndex = (currentPresetIndex + 1) % presets.size();
@@ -30,6 +38,54 @@ void PresetManager::loadPreviousPreset()
     loadPreset(prevIndex);
 }
 
+bool PresetManager::loadPresetFile(const juce::File& file)
+{
+    auto state = loadPresetFromFile(file);
+
+    if (!state.isValid() || !state.hasType(parameters.state.getType()))
+    {
+        return false;
+    }
+
+    applyPresetState(state);
+    return true;
+}
+
+void PresetManager::applyPresetState(const juce::ValueTree& state)
+{
+    // The audio thread plays the queued snapshot until replaceState() is done,
+    // so it never sees a mix of old and new values
+    const uint32_t generation = presetQueue.push(createSnapshot(state));
+    parameters.replaceState(state);
+    presetQueue.markApplied(generation);
+}
+
+ParameterSnapshot PresetManager::createSnapshot(const juce::ValueTree& state) const
+{
+    ParameterSnapshot snapshot;
+
+    for (int i = 0; i < ParameterSnapshot::NumParameters; ++i)
+    {
+        const juce::String paramID = ParameterSnapshot::parameterIDs[i];
+        auto* param = parameters.getParameter(paramID);
+        const auto child = state.getChildWithProperty("id", paramID);
+        jassert(param != nullptr);
+
+        // Parameters missing from older presets keep their current value, as in replaceState()
+        if (!child.hasProperty("value"))
+        {
+            snapshot[i] = parameters.getRawParameterValue(paramID)->load();
+            continue;
+        }
+
+        // Same rounding and snapping the APVTS applies to the stored value
+        const float value = static_cast<float>(child.getProperty("value"));
+        snapshot[i] = param->convertFrom0to1(param->convertTo0to1(value));
+    }
+
+    return snapshot;
+}
+
 // ========== PRESET SAVING ==========
 
 void PresetManager::saveUserPreset(const juce::String& presetName)
@@ -93,6 +149,18 @@ bool PresetManager::isFactoryPreset(int index) const
     return false;
 }
 
+int PresetManager::findPreset(const juce::String& name) const
+{
+    for (int i = 0; i < (int)presets.size(); ++i)
+    {
+        if (presets[i].name.equalsIgnoreCase(name))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
 // ========== FILE OPERATIONS ==========
 
 juce::File PresetManager::getUserPresetDirectory() const
@@ -2,22 +2,32 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_data_structures/juce_data_structures.h>
+#include "PresetQueue.h"
 
 /**
  * PresetManager
  * Handles saving, loading, and managing presets for CLEMMY3
  * Supports both factory (read-only) and user (read-write) presets
+ *
+ * Loading a preset first queues a flat snapshot of its values for the audio
+ * thread (see PresetQueue), then updates the APVTS for the editor and host.
  */
 class PresetManager
 {
 public:
-    PresetManager(juce::AudioProcessorValueTreeState& apvts);
+    PresetManager(juce::AudioProcessorValueTreeState& apvts, PresetQueue& queue);
     ~PresetManager() = default;
 
     // Preset loading
     void loadPreset(int presetIndex);
     void loadNextPreset();
     void loadPreviousPreset();
+    bool loadPresetFile(const juce::File& file);  // Any .clemmy3 file, not only user presets
+
+    // Queue a preset for the audio thread without updating the APVTS, as if
+    // replaceState() were still running (loadPreset() does both). The audio
+    // thread holds it until a later load completes. For CLEMMY3_RTCheck.
+    void queuePreset(int presetIndex);
 
     // Preset saving (user presets only)
     void saveUserPreset(const juce::String& presetName);
@@ -28,6 +38,7 @@ public:
     juce::String getPresetName(int index) const;
     int getCurrentPresetIndex() const { return currentPresetIndex; }
     bool isFactoryPreset(int index) const;
+    int findPreset(const juce::String& name) const;  // Index of the named preset, -1 if none
 
     // Initialization
     void loadFactoryPresets();
@@ -45,6 +56,7 @@ private:
     };
 
     juce::AudioProcessorValueTreeState& parameters;
+    PresetQueue& presetQueue;
     std::vector<Preset> presets;
     int currentPresetIndex = 0;
 
@@ -53,6 +65,10 @@ private:
     void savePresetToFile(const juce::String& presetName, const juce::ValueTree& state);
     juce::ValueTree loadPresetFromFile(const juce::File& file);
 
+    // Hand a preset state to the audio thread, then to the APVTS
+    void applyPresetState(const juce::ValueTree& state);
+    ParameterSnapshot createSnapshot(const juce::ValueTree& state) const;
+
     // Factory preset creation
     void createFactoryPresets();
     juce::ValueTree createPresetState(const std::map<juce::String, float>& paramValues);
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include "ParameterSnapshot.h"
+
+/**
+ * PresetQueue - Hands preset parameter snapshots to the audio thread
+ *
+ * Single producer (the message thread loading a preset), single consumer
+ * (processBlock). The producer flattens the preset into a ParameterSnapshot,
+ * pushes it, then updates the APVTS with replaceState() and marks that
+ * generation as applied. Until then the audio thread plays the pushed
+ * snapshot instead of the half-updated parameter values, so a preset change
+ * always reaches the voices as a whole, at a block boundary.
+ *
+ * Lock-free and allocation-free on both sides (juce::AbstractFifo over a
+ * fixed array).
+ */
+class PresetQueue
+{
+public:
+    static constexpr int CAPACITY = 8;
+
+    struct Entry
+    {
+        ParameterSnapshot parameters;
+        uint32_t generation = 0;
+    };
+
+    /**
+     * Queue a preset (message thread)
+     * @return Its generation, to pass to markApplied() once the APVTS holds
+     *         the same values, or 0 if the queue is full (audio not running)
+     */
+    uint32_t push(const ParameterSnapshot& parameters)
+    {
+        const auto scope = fifo.write(1);
+
+        if (scope.blockSize1 == 0)
+            return 0;
+
+        const uint32_t generation = ++lastGeneration;
+        entries[static_cast<size_t>(scope.startIndex1)] = { parameters, generation };
+        return generation;
+    }
+
+    /**
+     * The APVTS now holds the values of this generation (message thread)
+     */
+    void markApplied(uint32_t generation)
+    {
+        if (generation != 0)
+            appliedGeneration.store(generation, std::memory_order_release);
+    }
+
+    /**
+     * Take the newest queued preset, dropping older ones (audio thread)
+     * @return false if nothing was queued
+     */
+    bool popNewest(Entry& entry)
+    {
+        const int numReady = fifo.getNumReady();
+
+        if (numReady == 0)
+            return false;
+
+        const auto scope = fifo.read(numReady);
+        const int newest = scope.blockSize2 > 0 ? scope.startIndex2 + scope.blockSize2 - 1
+                                                : scope.startIndex1 + scope.blockSize1 - 1;
+        entry = entries[static_cast<size_t>(newest)];
+        return true;
+    }
+
+    /**
+     * Newest generation whose values are fully in the APVTS (audio thread)
+     */
+    uint32_t getAppliedGeneration() const
+    {
+        return appliedGeneration.load(std::memory_order_acquire);
+    }
+
+private:
+    juce::AbstractFifo fifo { CAPACITY };
+    std::array<Entry, CAPACITY> entries {};
+    uint32_t lastGeneration = 0;                   // Producer only
+    std::atomic<uint32_t> appliedGeneration { 0 };
+};
@@ -0,0 +1,251 @@
+#include "RealtimeCheck.h"
+
+#if CLEMMY3_RT_CHECK
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__)
+    #include <dlfcn.h>
+    #include <pthread.h>
+    #include <sched.h>
+    #include <sys/types.h>
+    #include <time.h>
+    #define CLEMMY3_RT_CHECK_LIBC 1
+#else
+    #define CLEMMY3_RT_CHECK_LIBC 0
+#endif
+
+// Initial-exec TLS never allocates on first access (this is read inside malloc)
+#if defined(__GNUC__)
+    #define CLEMMY3_RT_CHECK_TLS __attribute__((tls_model("initial-exec")))
+#else
+    #define CLEMMY3_RT_CHECK_TLS
+#endif
+
+namespace RealtimeCheck
+{
+    namespace
+    {
+        thread_local int audioThreadDepth CLEMMY3_RT_CHECK_TLS = 0;
+        std::atomic<uint64_t> counters[NumViolations] {};
+        std::atomic<bool> trapOnViolation { false };
+
+        void record(Violation violation)
+        {
+            if (audioThreadDepth == 0)
+                return;
+
+            counters[violation].fetch_add(1, std::memory_order_relaxed);
+
+            if (trapOnViolation.load(std::memory_order_relaxed))
+                std::abort();
+        }
+    }
+
+    ScopedAudioThread::ScopedAudioThread()
+    {
+        ++audioThreadDepth;
+    }
+
+    ScopedAudioThread::~ScopedAudioThread()
+    {
+        --audioThreadDepth;
+    }
+
+    Counts getCounts()
+    {
+        Counts counts;
+
+        for (int i = 0; i < NumViolations; ++i)
+            counts.values[i] = counters[i].load(std::memory_order_relaxed);
+
+        return counts;
+    }
+
+    void resetCounts()
+    {
+        for (auto& counter : counters)
+            counter.store(0, std::memory_order_relaxed);
+    }
+
+    void setTrapOnViolation(bool shouldTrap)
+    {
+        trapOnViolation = shouldTrap;
+    }
+}
+
+//==============================================================================
+// C library interposition (glibc): definitions in the program take precedence
+// over libc's, and forward to libc's internal entry points
+//==============================================================================
+
+#if CLEMMY3_RT_CHECK_LIBC
+
+extern "C"
+{
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* pointer, size_t size);
+    void __libc_free(void* pointer);
+    ssize_t __read(int fd, void* buffer, size_t size);
+    ssize_t __write(int fd, const void* buffer, size_t size);
+    int __nanosleep(const struct timespec* duration, struct timespec* remaining);
+    int __sched_yield();
+
+    void* malloc(size_t size)
+    {
+        RealtimeCheck::record(RealtimeCheck::Allocation);
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size)
+    {
+        RealtimeCheck::record(RealtimeCheck::Allocation);
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* pointer, size_t size)
+    {
+        RealtimeCheck::record(RealtimeCheck::Allocation);
+        return __libc_realloc(pointer, size);
+    }
+
+    void free(void* pointer)
+    {
+        if (pointer != nullptr)
+            RealtimeCheck::record(RealtimeCheck::Deallocation);
+
+        __libc_free(pointer);
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex)
+    {
+        // libc's own version (resolved once; dlsym doesn't lock through this function)
+        using MutexLock = int (*)(pthread_mutex_t*);
+        static std::atomic<MutexLock> libcMutexLock { nullptr };
+
+        MutexLock lock = libcMutexLock.load(std::memory_order_acquire);
+
+        if (lock == nullptr)
+        {
+            lock = reinterpret_cast<MutexLock>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+            libcMutexLock.store(lock, std::memory_order_release);
+        }
+
+        RealtimeCheck::record(RealtimeCheck::Lock);
+        return lock(mutex);
+    }
+
+    ssize_t read(int fd, void* buffer, size_t size)
+    {
+        RealtimeCheck::record(RealtimeCheck::SystemCall);
+        return __read(fd, buffer, size);
+    }
+
+    ssize_t write(int fd, const void* buffer, size_t size)
+    {
+        RealtimeCheck::record(RealtimeCheck::SystemCall);
+        return __write(fd, buffer, size);
+    }
+
+    int nanosleep(const struct timespec* duration, struct timespec* remaining)
+    {
+        RealtimeCheck::record(RealtimeCheck::SystemCall);
+        return __nanosleep(duration, remaining);
+    }
+
+    int sched_yield()
+    {
+        RealtimeCheck::record(RealtimeCheck::SystemCall);
+        return __sched_yield();
+    }
+}
+
+#endif
+
+//==============================================================================
+// C++ allocator replacement (all platforms). With glibc the malloc/free
+// above already count, so these only forward.
+//==============================================================================
+
+namespace
+{
+    void* allocate(std::size_t size)
+    {
+       #if ! CLEMMY3_RT_CHECK_LIBC
+        RealtimeCheck::record(RealtimeCheck::Allocation);
+       #endif
+
+        if (void* pointer = std::malloc(size != 0 ? size : 1))
+            return pointer;
+
+        throw std::bad_alloc();
+    }
+
+    void deallocate(void* pointer) noexcept
+    {
+       #if ! CLEMMY3_RT_CHECK_LIBC
+        if (pointer != nullptr)
+            RealtimeCheck::record(RealtimeCheck::Deallocation);
+       #endif
+
+        std::free(pointer);
+    }
+
+    // aligned_alloc isn't interposed, so aligned allocations always count here
+    void* allocateAligned(std::size_t size, std::align_val_t alignment)
+    {
+        RealtimeCheck::record(RealtimeCheck::Allocation);
+
+        const auto align = static_cast<std::size_t>(alignment);
+        const std::size_t roundedSize = (size + align - 1) / align * align;
+
+       #if defined(_MSC_VER)
+        void* pointer = _aligned_malloc(roundedSize != 0 ? roundedSize : align, align);
+       #else
+        void* pointer = std::aligned_alloc(align, roundedSize != 0 ? roundedSize : align);
+       #endif
+
+        if (pointer != nullptr)
+            return pointer;
+
+        throw std::bad_alloc();
+    }
+
+    void deallocateAligned(void* pointer) noexcept
+    {
+       #if defined(_MSC_VER)
+        if (pointer != nullptr)
+            RealtimeCheck::record(RealtimeCheck::Deallocation);
+
+        _aligned_free(pointer);
+       #else
+        deallocate(pointer);
+       #endif
+    }
+}
+
+void* operator new(std::size_t size)                                   { return allocate(size); }
+void* operator new[](std::size_t size)                                 { return allocate(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept   { try { return allocate(size); } catch (...) { return nullptr; } }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { try { return allocate(size); } catch (...) { return nullptr; } }
+
+void operator delete(void* pointer) noexcept                                { deallocate(pointer); }
+void operator delete[](void* pointer) noexcept                              { deallocate(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept                   { deallocate(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept                 { deallocate(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept         { deallocate(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept       { deallocate(pointer); }
+
+void* operator new(std::size_t size, std::align_val_t alignment)   { return allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+
+void operator delete(void* pointer, std::align_val_t) noexcept                { deallocateAligned(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept              { deallocateAligned(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept   { deallocateAligned(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { deallocateAligned(pointer); }
+
+#endif
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Build with CLEMMY3_RT_CHECK=1 (CMake option CLEMMY3_RT_CHECK) to count
+ * real-time safety violations on the audio thread
+ */
+#ifndef CLEMMY3_RT_CHECK
+    #define CLEMMY3_RT_CHECK 0
+#endif
+
+/**
+ * RealtimeCheck - Detects allocations, locks and system calls on the audio thread
+ *
+ * processBlock marks its thread with a ScopedAudioThread. In checking builds
+ * the allocator (operator new/delete everywhere, malloc/free on glibc),
+ * pthread_mutex_lock and a set of blocking system calls (read, write,
+ * nanosleep, sched_yield; glibc only) are interposed, and every call made
+ * while a ScopedAudioThread is alive is counted. Worker threads of the voice
+ * render pool are not marked.
+ *
+ * In normal builds nothing is interposed and ScopedAudioThread compiles away.
+ */
+namespace RealtimeCheck
+{
+    enum Violation
+    {
+        Allocation = 0,  // malloc, calloc, realloc, operator new
+        Deallocation,    // free, operator delete
+        Lock,            // pthread_mutex_lock (std::mutex, juce::CriticalSection)
+        SystemCall,      // read, write, nanosleep, sched_yield
+        NumViolations
+    };
+
+    struct Counts
+    {
+        uint64_t values[NumViolations] {};
+
+        uint64_t total() const
+        {
+            uint64_t sum = 0;
+
+            for (const auto value : values)
+                sum += value;
+
+            return sum;
+        }
+    };
+
+   #if CLEMMY3_RT_CHECK
+    /**
+     * Marks the current thread as the audio thread while in scope (nestable)
+     */
+    class ScopedAudioThread
+    {
+    public:
+        ScopedAudioThread();
+        ~ScopedAudioThread();
+
+        ScopedAudioThread(const ScopedAudioThread&) = delete;
+        ScopedAudioThread& operator=(const ScopedAudioThread&) = delete;
+    };
+
+    /**
+     * Violations counted since the last resetCounts()
+     */
+    Counts getCounts();
+    void resetCounts();
+
+    /**
+     * Abort on the first violation, so a debugger stops on the offending call
+     */
+    void setTrapOnViolation(bool shouldTrap);
+   #else
+    class ScopedAudioThread
+    {
+    public:
+        ScopedAudioThread() {}
+    };
+
+    inline Counts getCounts() { return {}; }
+    inline void resetCounts() {}
+    inline void setTrapOnViolation(bool) {}
+   #endif
+
+    /**
+     * Display name of a violation type
+     */
+    inline const char* getName(Violation violation)
+    {
+        switch (violation)
+        {
+            case Allocation:   return "allocations";
+            case Deallocation: return "deallocations";
+            case Lock:         return "locks";
+            case SystemCall:   return "system calls";
+            default:           return "";
+        }
+    }
+}
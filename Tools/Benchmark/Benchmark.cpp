@@ -0,0 +1,555 @@
+/**
+ * CLEMMY3_Bench - Headless benchmark for the DSP engine
+ *
+ * Renders a fixed amount of audio through each DSP class (no JUCE, no editor)
+ * in host-sized blocks and reports, per case:
+ * - nsPerSample:      wall-clock nanoseconds per rendered sample (best run)
+ * - samplesPerSecond: throughput
+ * - realtimeFactor:   audio seconds rendered per wall-clock second
+ * - cpuPercent:       share of one core needed to run in real time
+ *
+ * Usage: CLEMMY3_Bench [--seconds 2] [--sample-rate 48000] [--block-size 64]
+ *                      [--repeats 3] [--render-threads N] [--output results.json]
+ *
+ * --render-threads sets the worker count for the parallel voice rendering
+ * cases (default: one less than the number of cores).
+ *
+ * Results are written as JSON (to stdout unless --output is given), so CI can
+ * compare them against a stored baseline.
+ */
+
+#include "Envelope.h"
+#include "LFO.h"
+#include "MoogFilter.h"
+#include "NoiseGenerator.h"
+#include "Oscillator.h"
+#include "Voice.h"
+#include "VoiceManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Settings
+    {
+        double sampleRate = 48000.0;
+        int blockSize = 64;
+        double seconds = 2.0;
+        int repeats = 3;
+        int renderThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+        const char* outputPath = nullptr;
+    };
+
+    struct Result
+    {
+        std::string name;
+        double nsPerSample = 0.0;
+        double samplesPerSecond = 0.0;
+        double realtimeFactor = 0.0;
+    };
+
+    // Keeps the optimizer from discarding rendered audio
+    volatile float checksum = 0.0f;
+
+    /**
+     * Time one benchmark case
+     * @param prepare Called before every run (reset state, trigger notes)
+     * @param render Called per block: render(float* buffer, int numSamples)
+     */
+    template <typename Prepare, typename Render>
+    Result measure(const std::string& name, const Settings& settings, Prepare prepare, Render render)
+    {
+        std::vector<float> buffer(static_cast<size_t>(settings.blockSize), 0.0f);
+        const long long totalSamples = static_cast<long long>(settings.seconds * settings.sampleRate);
+        double bestSeconds = std::numeric_limits<double>::max();
+
+        for (int run = 0; run < settings.repeats; ++run)
+        {
+            prepare();
+
+            float sum = 0.0f;
+            const auto start = std::chrono::steady_clock::now();
+
+            for (long long done = 0; done < totalSamples; done += settings.blockSize)
+            {
+                const int numSamples = static_cast<int>(std::min<long long>(settings.blockSize, totalSamples - done));
+                render(buffer.data(), numSamples);
+                sum += buffer[0];
+            }
+
+            const auto end = std::chrono::steady_clock::now();
+            bestSeconds = std::min(bestSeconds, std::chrono::duration<double>(end - start).count());
+            checksum = checksum + sum;
+        }
+
+        Result result;
+        result.name = name;
+        result.nsPerSample = bestSeconds * 1.0e9 / static_cast<double>(totalSamples);
+        result.samplesPerSecond = static_cast<double>(totalSamples) / bestSeconds;
+        result.realtimeFactor = result.samplesPerSecond / settings.sampleRate;
+        return result;
+    }
+
+    //==============================================================================
+    // Benchmark cases
+    //==============================================================================
+
+    void benchmarkOscillators(const Settings& settings, std::vector<Result>& results)
+    {
+        const std::pair<Oscillator::Waveform, const char*> waveforms[] =
+        {
+            { Oscillator::Waveform::Sine, "sine" },
+            { Oscillator::Waveform::Sawtooth, "sawtooth" },
+            { Oscillator::Waveform::Square, "square" },
+            { Oscillator::Waveform::Triangle, "triangle" }
+        };
+
+        const std::pair<Oscillator::Engine, const char*> engines[] =
+        {
+            { Oscillator::Engine::PolyBLEP, "" },
+            { Oscillator::Engine::Wavetable, "wavetable_" }
+        };
+
+        for (const auto& [engine, prefix] : engines)
+        {
+            for (const auto& [waveform, name] : waveforms)
+            {
+                Oscillator oscillator;
+                oscillator.setSampleRate(settings.sampleRate);
+                oscillator.setWaveform(waveform);
+                oscillator.setEngine(engine);
+                oscillator.setFrequency(220.0f);
+
+                results.push_back(measure(std::string("oscillator/") + prefix + name, settings,
+                    [&] { oscillator.reset(); },
+                    [&](float* buffer, int numSamples) { oscillator.processBlock(buffer, numSamples); }));
+            }
+        }
+    }
+
+    void benchmarkFilter(const Settings& settings, std::vector<Result>& results)
+    {
+        const std::pair<MoogFilter::Mode, const char*> modes[] =
+        {
+            { MoogFilter::LowPass, "lowpass" },
+            { MoogFilter::BandPass, "bandpass" },
+            { MoogFilter::HighPass, "highpass" }
+        };
+
+        const std::pair<MoogFilter::Model, const char*> models[] =
+        {
+            { MoogFilter::Classic, "" },
+            { MoogFilter::ZeroDelay, "zdf_" }
+        };
+
+        // Filter a sawtooth so the ladder sees a realistic signal
+        Oscillator source;
+        source.setSampleRate(settings.sampleRate);
+        source.setWaveform(Oscillator::Waveform::Sawtooth);
+        source.setFrequency(110.0f);
+
+        std::vector<float> input(static_cast<size_t>(settings.blockSize));
+        source.processBlock(input.data(), settings.blockSize);
+
+        for (const auto& [model, prefix] : models)
+        {
+            for (const auto& [mode, name] : modes)
+            {
+                MoogFilter filter;
+                filter.setSampleRate(settings.sampleRate);
+                filter.setModel(model);
+                filter.setMode(mode);
+                filter.setCutoff(2000.0f);
+                filter.setResonance(0.5f);
+
+                results.push_back(measure(std::string("filter/") + prefix + name, settings,
+                    [&] { filter.reset(); },
+                    [&](float* buffer, int numSamples)
+                    {
+                        std::copy(input.begin(), input.begin() + numSamples, buffer);
+                        filter.processBlock(buffer, numSamples);
+                    }));
+            }
+        }
+    }
+
+    void benchmarkEnvelope(const Settings& settings, std::vector<Result>& results)
+    {
+        Envelope envelope;
+        envelope.setSampleRate(settings.sampleRate);
+        envelope.setParameters(0.01f, 0.1f, 0.7f, 0.2f);
+
+        // Retrigger four times a second so every phase is exercised
+        const long long notePeriod = static_cast<long long>(settings.sampleRate / 4.0);
+        long long position = 0;
+
+        results.push_back(measure("envelope", settings,
+            [&]
+            {
+                envelope.reset();
+                envelope.noteOn(1.0f);
+                position = 0;
+            },
+            [&](float* buffer, int numSamples)
+            {
+                envelope.processBlock(buffer, numSamples);
+
+                // Note on at the start of each period, note off halfway through
+                const long long before = position % notePeriod;
+                position += numSamples;
+                const long long after = position % notePeriod;
+
+                if (after < before)
+                    envelope.noteOn(1.0f);
+                else if (before < notePeriod / 2 && after >= notePeriod / 2)
+                    envelope.noteOff();
+            }));
+    }
+
+    void benchmarkLFO(const Settings& settings, std::vector<Result>& results)
+    {
+        const std::pair<LFO::Waveform, const char*> waveforms[] =
+        {
+            { LFO::Sine, "sine" },
+            { LFO::SampleAndHold, "sample_and_hold" }
+        };
+
+        for (const auto& [waveform, name] : waveforms)
+        {
+            LFO lfo;
+            lfo.setSampleRate(settings.sampleRate);
+            lfo.setWaveform(waveform);
+            lfo.setRate(5.0f);
+            lfo.setDepth(1.0f);
+
+            results.push_back(measure(std::string("lfo/") + name, settings,
+                [&] { lfo.reset(); },
+                [&](float* buffer, int numSamples) { lfo.processBlock(buffer, numSamples); }));
+        }
+    }
+
+    void benchmarkNoise(const Settings& settings, std::vector<Result>& results)
+    {
+        const std::pair<NoiseGenerator::NoiseType, const char*> types[] =
+        {
+            { NoiseGenerator::NoiseType::White, "white" },
+            { NoiseGenerator::NoiseType::Pink, "pink" },
+            { NoiseGenerator::NoiseType::Brown, "brown" }
+        };
+
+        for (const auto& [type, name] : types)
+        {
+            NoiseGenerator noise;
+            noise.setSampleRate(settings.sampleRate);
+            noise.setNoiseType(type);
+
+            results.push_back(measure(std::string("noise/") + name, settings,
+                [&] { noise.reset(); },
+                [&](float* buffer, int numSamples) { noise.processBlock(buffer, numSamples); }));
+        }
+    }
+
+    /**
+     * A typical patch: two detuned oscillators into a resonant low-pass
+     */
+    template <typename Target>
+    void setUpPatch(Target& target)
+    {
+        target.setOscillatorEnabled(0, true);
+        target.setOscillatorWaveform(0, Oscillator::Waveform::Sawtooth);
+        target.setOscillatorEnabled(1, true);
+        target.setOscillatorWaveform(1, Oscillator::Waveform::Square);
+        target.setOscillatorDetune(1, 7.0f);
+        target.setOscillatorEnabled(2, false);
+        target.setFilterCutoff(2000.0f);
+        target.setFilterResonance(0.4f);
+        target.setEnvelopeParameters(0.01f, 0.2f, 0.7f, 0.3f);
+    }
+
+    void benchmarkVoice(const Settings& settings, std::vector<Result>& results)
+    {
+        for (int oversampling : { 1, 2, 4 })
+        {
+            auto voice = std::make_unique<Voice>();
+            voice->setSampleRate(settings.sampleRate);
+            voice->setOversampling(oversampling);
+            setUpPatch(*voice);
+
+            results.push_back(measure(oversampling == 1 ? std::string("voice") : "voice/oversampled_" + std::to_string(oversampling) + "x", settings,
+                [&]
+                {
+                    voice->reset();
+                    voice->noteOn(48, 0.8f);
+                },
+                [&](float* buffer, int numSamples)
+                {
+                    std::fill(buffer, buffer + numSamples, 0.0f);
+                    voice->renderBlock(buffer, numSamples);
+                }));
+        }
+
+        // LFO on the cutoff: coefficients are updated at control rate
+        const std::pair<MoogFilter::Model, const char*> models[] =
+        {
+            { MoogFilter::Classic, "voice/filter_lfo" },
+            { MoogFilter::ZeroDelay, "voice/filter_lfo_zdf" }
+        };
+
+        for (const auto& [model, name] : models)
+        {
+            auto voice = std::make_unique<Voice>();
+            voice->setSampleRate(settings.sampleRate);
+            setUpPatch(*voice);
+            voice->setFilterModel(model);
+            voice->setLFO1Rate(4.0f);
+            voice->setLFO1Depth(0.5f);
+            voice->setLFO1Destination(1);  // Filter cutoff
+
+            results.push_back(measure(name, settings,
+                [&]
+                {
+                    voice->reset();
+                    voice->noteOn(48, 0.8f);
+                },
+                [&](float* buffer, int numSamples)
+                {
+                    std::fill(buffer, buffer + numSamples, 0.0f);
+                    voice->renderBlock(buffer, numSamples);
+                }));
+        }
+
+        // Full modulation matrix: both LFOs plus user slots on pitch, PWM,
+        // cutoff and volume
+        {
+            auto voice = std::make_unique<Voice>();
+            voice->setSampleRate(settings.sampleRate);
+            setUpPatch(*voice);
+            voice->setLFO1Rate(4.0f);
+            voice->setLFO1Depth(0.5f);
+            voice->setLFO1Destination(1);  // Filter cutoff
+            voice->setLFO2Rate(5.5f);
+            voice->setLFO2Depth(0.3f);
+            voice->setLFO2Destination(2);  // Pitch
+            voice->setModulationSlot(0, ModulationMatrix::SourceEnvelope, ModulationMatrix::DestFilterCutoff, 0.5f);
+            voice->setModulationSlot(1, ModulationMatrix::SourceLFO1, ModulationMatrix::DestPWM, 0.8f);
+            voice->setModulationSlot(2, ModulationMatrix::SourceModWheel, ModulationMatrix::DestVolume, -0.5f);
+            voice->setModulationSlot(3, ModulationMatrix::SourceNote, ModulationMatrix::DestFilterRes, 0.3f);
+            voice->setModWheel(0.5f);
+
+            results.push_back(measure("voice/mod_matrix", settings,
+                [&]
+                {
+                    voice->reset();
+                    voice->noteOn(48, 0.8f);
+                },
+                [&](float* buffer, int numSamples)
+                {
+                    std::fill(buffer, buffer + numSamples, 0.0f);
+                    voice->renderBlock(buffer, numSamples);
+                }));
+        }
+    }
+
+    void benchmarkVoiceManager(const Settings& settings, std::vector<Result>& results)
+    {
+        const std::pair<VoiceManager::VoiceMode, const char*> modes[] =
+        {
+            { VoiceManager::VoiceMode::Mono, "mono" },
+            { VoiceManager::VoiceMode::Poly, "poly" },
+            { VoiceManager::VoiceMode::Unison, "unison" }
+        };
+
+        for (const auto& [mode, name] : modes)
+        {
+            // Mono always plays a single voice
+            const int maxVoices = mode == VoiceManager::VoiceMode::Mono ? 1 : VoiceManager::DEFAULT_VOICES;
+
+            for (int numVoices = 1; numVoices <= maxVoices; ++numVoices)
+            {
+                auto manager = std::make_unique<VoiceManager>();
+                manager->prepare(settings.sampleRate, VoiceManager::DEFAULT_VOICES);
+                manager->setVoiceMode(mode);
+                manager->setUnisonVoices(numVoices);
+                setUpPatch(*manager);
+
+                results.push_back(measure(std::string("voicemanager/") + name + "/" + std::to_string(numVoices), settings,
+                    [&]
+                    {
+                        manager->allSoundOff();
+
+                        if (mode == VoiceManager::VoiceMode::Poly)
+                        {
+                            for (int i = 0; i < numVoices; ++i)
+                                manager->noteOn(48 + i * 3, 0.8f);
+                        }
+                        else
+                        {
+                            manager->noteOn(48, 0.8f);
+                        }
+                    },
+                    [&](float* buffer, int numSamples) { manager->renderBlock(buffer, numSamples); }));
+            }
+        }
+
+        // Both LFOs modulating a full chord, one LFO pair per voice vs one shared pair
+        for (bool global : { false, true })
+        {
+            auto manager = std::make_unique<VoiceManager>();
+            manager->prepare(settings.sampleRate, VoiceManager::DEFAULT_VOICES);
+            manager->setVoiceMode(VoiceManager::VoiceMode::Poly);
+            setUpPatch(*manager);
+            manager->setLFO1Rate(4.0f);
+            manager->setLFO1Depth(0.5f);
+            manager->setLFO1Destination(1);  // Filter cutoff
+            manager->setLFO2Waveform(LFO::SampleAndHold);
+            manager->setLFO2Rate(8.0f);
+            manager->setLFO2Depth(0.3f);
+            manager->setLFO2Destination(3);  // PWM
+            manager->setLFO1Global(global);
+            manager->setLFO2Global(global);
+
+            const int numVoices = VoiceManager::DEFAULT_VOICES;
+
+            results.push_back(measure(std::string(global ? "voicemanager/poly_lfo_global/" : "voicemanager/poly_lfo/") + std::to_string(numVoices), settings,
+                [&]
+                {
+                    manager->allSoundOff();
+
+                    for (int i = 0; i < numVoices; ++i)
+                        manager->noteOn(48 + i * 3, 0.8f);
+                },
+                [&](float* buffer, int numSamples) { manager->renderBlock(buffer, numSamples); }));
+        }
+
+        // Large poly chords rendered on the audio thread alone vs with the worker pool
+        for (const int threads : { 0, settings.renderThreads })
+        {
+            for (const int numVoices : { VoiceManager::DEFAULT_VOICES, VoiceManager::MAX_VOICES })
+            {
+                auto manager = std::make_unique<VoiceManager>();
+                manager->prepare(settings.sampleRate, VoiceManager::MAX_VOICES);
+                manager->setVoiceMode(VoiceManager::VoiceMode::Poly);
+                manager->setPolyphony(numVoices);
+                manager->setNumRenderThreads(threads);
+                setUpPatch(*manager);
+
+                results.push_back(measure("voicemanager/poly_threads" + std::to_string(threads) + "/" + std::to_string(numVoices), settings,
+                    [&]
+                    {
+                        manager->allSoundOff();
+
+                        for (int i = 0; i < numVoices; ++i)
+                            manager->noteOn(36 + i, 0.8f);
+                    },
+                    [&](float* buffer, int numSamples) { manager->renderBlock(buffer, numSamples); }));
+            }
+        }
+    }
+
+    //==============================================================================
+    // Command line and output
+    //==============================================================================
+
+    bool parseArguments(int argc, char** argv, Settings& settings)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const char* arg = argv[i];
+            const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+            if (value == nullptr)
+                return false;
+
+            if (std::strcmp(arg, "--seconds") == 0)
+                settings.seconds = std::atof(value);
+            else if (std::strcmp(arg, "--sample-rate") == 0)
+                settings.sampleRate = std::atof(value);
+            else if (std::strcmp(arg, "--block-size") == 0)
+                settings.blockSize = std::atoi(value);
+            else if (std::strcmp(arg, "--repeats") == 0)
+                settings.repeats = std::atoi(value);
+            else if (std::strcmp(arg, "--render-threads") == 0)
+                settings.renderThreads = std::atoi(value);
+            else if (std::strcmp(arg, "--output") == 0)
+                settings.outputPath = value;
+            else
+                return false;
+
+            ++i;
+        }
+
+        return settings.seconds > 0.0 && settings.sampleRate > 0.0
+            && settings.blockSize > 0 && settings.repeats > 0 && settings.renderThreads > 0;
+    }
+
+    void writeJson(std::FILE* file, const Settings& settings, const std::vector<Result>& results)
+    {
+        std::fprintf(file, "{\n");
+        std::fprintf(file, "  \"sampleRate\": %.0f,\n", settings.sampleRate);
+        std::fprintf(file, "  \"blockSize\": %d,\n", settings.blockSize);
+        std::fprintf(file, "  \"secondsPerRun\": %g,\n", settings.seconds);
+        std::fprintf(file, "  \"repeats\": %d,\n", settings.repeats);
+        std::fprintf(file, "  \"renderThreads\": %d,\n", settings.renderThreads);
+        std::fprintf(file, "  \"results\": [\n");
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& r = results[i];
+            std::fprintf(file,
+                         "    { \"name\": \"%s\", \"nsPerSample\": %.3f, \"samplesPerSecond\": %.0f, "
+                         "\"realtimeFactor\": %.2f, \"cpuPercent\": %.4f }%s\n",
+                         r.name.c_str(), r.nsPerSample, r.samplesPerSecond,
+                         r.realtimeFactor, 100.0 / r.realtimeFactor,
+                         i + 1 < results.size() ? "," : "");
+        }
+
+        std::fprintf(file, "  ]\n}\n");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Settings settings;
+
+    if (!parseArguments(argc, argv, settings))
+    {
+        std::fprintf(stderr,
+                     "Usage: %s [--seconds 2] [--sample-rate 48000] [--block-size 64] "
+                     "[--repeats 3] [--render-threads N] [--output results.json]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<Result> results;
+
+    benchmarkOscillators(settings, results);
+    benchmarkFilter(settings, results);
+    benchmarkEnvelope(settings, results);
+    benchmarkLFO(settings, results);
+    benchmarkNoise(settings, results);
+    benchmarkVoice(settings, results);
+    benchmarkVoiceManager(settings, results);
+
+    std::FILE* file = settings.outputPath != nullptr ? std::fopen(settings.outputPath, "w") : stdout;
+
+    if (file == nullptr)
+    {
+        std::fprintf(stderr, "Could not open %s\n", settings.outputPath);
+        return 1;
+    }
+
+    writeJson(file, settings, results);
+
+    if (file != stdout)
+        std::fclose(file);
+
+    return 0;
+}
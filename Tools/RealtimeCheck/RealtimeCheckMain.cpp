@@ -0,0 +1,218 @@
+/**
+ * CLEMMY3_RTCheck - Real-time safety check of the audio thread
+ *
+ * Built when CMake is configured with -DCLEMMY3_RT_CHECK=ON. Drives
+ * CLEMMY3AudioProcessor::processBlock through every preset, voice mode and
+ * LFO destination (with MIDI notes, mod wheel and a playing transport) and
+ * reports any allocation, lock or system call made inside processBlock
+ * (see Source/RealtimeCheck.h). Preset and parameter changes are made between
+ * blocks, as the message thread would. Each preset also gets a segment in
+ * which the next preset is queued but not yet in the APVTS, so processBlock
+ * plays the held snapshot and fades between the presets.
+ *
+ * Usage:
+ *   CLEMMY3_RTCheck [--blocks 16] [--block-size 256] [--sample-rate 48000]
+ *                   [--render-threads 0] [--trap]
+ *
+ * Exits with 1 if anything was counted. --trap aborts on the first violation
+ * instead, so a debugger shows the offending call.
+ */
+
+#include "PluginProcessor.h"
+#include "RealtimeCheck.h"
+#include <functional>
+#include <iostream>
+
+namespace
+{
+    /**
+     * Playing transport at a fixed tempo
+     */
+    class CheckPlayHead : public juce::AudioPlayHead
+    {
+    public:
+        explicit CheckPlayHead(double sampleRate) : rate(sampleRate) {}
+
+        void advance(int numSamples) { timeInSamples += numSamples; }
+
+        juce::Optional<PositionInfo> getPosition() const override
+        {
+            const double seconds = static_cast<double>(timeInSamples) / rate;
+
+            PositionInfo info;
+            info.setBpm(120.0);
+            info.setTimeInSamples(timeInSamples);
+            info.setTimeInSeconds(seconds);
+            info.setPpqPosition(seconds * 2.0);
+            info.setIsPlaying(true);
+            return info;
+        }
+
+    private:
+        const double rate;
+        juce::int64 timeInSamples = 0;
+    };
+
+    void printUsage()
+    {
+        std::cerr << "Usage: CLEMMY3_RTCheck [--blocks 16] [--block-size 256] [--sample-rate 48000]\n"
+                     "                       [--render-threads 0] [--trap]\n";
+    }
+
+    juce::String getOption(const juce::ArgumentList& args, const juce::String& option, const juce::String& fallback)
+    {
+        return args.containsOption(option) ? args.getValueForOption(option) : fallback;
+    }
+
+    void setParameter(CLEMMY3AudioProcessor& processor, const juce::String& parameterID, float value)
+    {
+        auto* parameter = processor.parameters.getParameter(parameterID);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    const juce::ArgumentList args(argc, argv);
+
+    const int numBlocks = getOption(args, "--blocks", "16").getIntValue();
+    const int blockSize = getOption(args, "--block-size", "256").getIntValue();
+    const double sampleRate = getOption(args, "--sample-rate", "48000").getDoubleValue();
+    const int renderThreads = getOption(args, "--render-threads", "0").getIntValue();
+    const int numChannels = 2;
+
+    if (numBlocks <= 0 || blockSize <= 0 || sampleRate <= 0.0 || renderThreads < 0)
+    {
+        printUsage();
+        return 1;
+    }
+
+    RealtimeCheck::setTrapOnViolation(args.containsOption("--trap"));
+
+    auto processor = std::make_unique<CLEMMY3AudioProcessor>();
+    auto& presetManager = processor->getPresetManager();
+
+    CheckPlayHead playHead(sampleRate);
+    processor->setPlayHead(&playHead);
+    processor->setNumRenderThreads(renderThreads);
+    processor->setPlayConfigDetails(0, numChannels, sampleRate, blockSize);
+    processor->prepareToPlay(sampleRate, blockSize);
+
+    // Host-owned buffers, allocated up front like a host would
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::MidiBuffer midiBuffer;
+    midiBuffer.ensureSize(4096);
+
+    const int numDestinations = 6;  // Same order as the lfoNDestination choices
+    int numSegments = 0;
+    int failedSegments = 0;
+    RealtimeCheck::Counts totals;
+
+    // Renders numBlocks blocks and reports what processBlock did; betweenBlocks(block)
+    // runs before each block on this thread, like message thread work would
+    auto checkSegment = [&](const juce::String& name, const std::function<void(int)>& betweenBlocks)
+    {
+        RealtimeCheck::resetCounts();
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            betweenBlocks(block);
+
+            // A chord at the start, mod wheel moves, then note-offs halfway
+            midiBuffer.clear();
+
+            if (block == 0)
+            {
+                for (const int note : { 48, 52, 55, 59 })
+                    midiBuffer.addEvent(juce::MidiMessage::noteOn(1, note, 0.8f), 0);
+            }
+
+            midiBuffer.addEvent(juce::MidiMessage::controllerEvent(1, 1, (block * 8) % 128), blockSize / 2);
+
+            if (block == numBlocks / 2)
+            {
+                for (const int note : { 48, 52, 55, 59 })
+                    midiBuffer.addEvent(juce::MidiMessage::noteOff(1, note), blockSize - 1);
+            }
+
+            buffer.clear();
+            processor->processBlock(buffer, midiBuffer);
+            playHead.advance(blockSize);
+        }
+
+        const auto counts = RealtimeCheck::getCounts();
+        ++numSegments;
+
+        if (counts.total() > 0)
+        {
+            ++failedSegments;
+            std::cout << name << ":";
+
+            for (int i = 0; i < RealtimeCheck::NumViolations; ++i)
+            {
+                if (counts.values[i] > 0)
+                    std::cout << " " << counts.values[i] << " " << RealtimeCheck::getName(static_cast<RealtimeCheck::Violation>(i));
+            }
+
+            std::cout << "\n";
+        }
+
+        for (int i = 0; i < RealtimeCheck::NumViolations; ++i)
+            totals.values[i] += counts.values[i];
+    };
+
+    for (int preset = 0; preset < presetManager.getNumPresets(); ++preset)
+    {
+        presetManager.loadPreset(preset);
+
+        for (int voiceMode = 0; voiceMode < 3; ++voiceMode)
+        {
+            for (int destination = 0; destination < numDestinations; ++destination)
+            {
+                setParameter(*processor, "voiceMode", static_cast<float>(voiceMode));
+                setParameter(*processor, "lfo1Destination", static_cast<float>(destination));
+                setParameter(*processor, "lfo2Destination", static_cast<float>((destination + 1) % numDestinations));
+                setParameter(*processor, "lfo1Depth", 0.5f);
+                setParameter(*processor, "lfo2Depth", 0.5f);
+                setParameter(*processor, "lfo1Mode", static_cast<float>(destination % 2));
+                setParameter(*processor, "deterministicRender", static_cast<float>(voiceMode % 2));
+
+                checkSegment(presetManager.getPresetName(preset) + ", voice mode " + juce::String(voiceMode)
+                                 + ", LFO destination " + juce::String(destination),
+                             [](int) {});
+            }
+        }
+
+        // Preset change while notes sound: the next preset is queued a quarter
+        // of the way in and held on the audio thread (the APVTS is not updated,
+        // parameter edits are ignored) until the load completes three quarters in
+        const int nextPreset = (preset + 1) % presetManager.getNumPresets();
+
+        checkSegment(presetManager.getPresetName(preset) + " to " + presetManager.getPresetName(nextPreset)
+                         + ", held preset change",
+                     [&](int block)
+                     {
+                         if (block == numBlocks / 4)
+                             presetManager.queuePreset(nextPreset);
+
+                         if (block > numBlocks / 4 && block < numBlocks * 3 / 4)
+                             setParameter(*processor, "lfo1Depth", static_cast<float>(block % 2));
+
+                         if (block == numBlocks * 3 / 4)
+                             presetManager.loadPreset(nextPreset);
+                     });
+    }
+
+    processor->releaseResources();
+    processor->setPlayHead(nullptr);
+
+    std::cout << numSegments << " segments, " << failedSegments << " with violations";
+
+    for (int i = 0; i < RealtimeCheck::NumViolations; ++i)
+        std::cout << ", " << totals.values[i] << " " << RealtimeCheck::getName(static_cast<RealtimeCheck::Violation>(i));
+
+    std::cout << "\n";
+
+    return failedSegments == 0 ? 0 : 1;
+}
@@ -0,0 +1,388 @@
+/**
+ * CLEMMY3_Render - Offline, faster-than-realtime renderer
+ *
+ * Loads a preset (a .clemmy3 file or a factory/user preset by name), plays a
+ * Standard MIDI File through CLEMMY3AudioProcessor::processBlock with large
+ * buffers in non-realtime mode and writes the result to a WAV file.
+ *
+ * Usage:
+ *   CLEMMY3_Render --midi song.mid --output stem.wav
+ *                  [--preset patch.clemmy3 | --factory "[LEAD] SuperSaw I"]
+ *                  [--sample-rate 48000] [--block-size 4096] [--bit-depth 24]
+ *                  [--tail 2.0] [--seed 1] [--cache-dir <dir>] [--render-threads 0]
+ *   CLEMMY3_Render --list-presets
+ *
+ * Tempo changes in the MIDI file are reported to the processor through a
+ * play head, so tempo-synced LFOs follow the song. With --seed the render
+ * runs in Deterministic Render mode: the same seed, preset and MIDI file
+ * always give the same samples.
+ *
+ * --render-threads N renders the voices on N worker threads plus the main
+ * thread (capped at the number of cores minus one), for large polyphonic
+ * stems on many-core render nodes. The thread count only changes the speed:
+ * voices are summed in fixed slices, so the samples are the same on any node.
+ *
+ * With --cache-dir, finished renders are kept in that directory under a hash
+ * of the processor state, the MIDI events and the render settings; a later
+ * render with the same hash copies the cached WAV instead of rendering.
+ * The cache is only used together with --seed: otherwise every run has a new
+ * random seed, so no render could ever be reused.
+ */
+
+#include "PluginProcessor.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_cryptography/juce_cryptography.h>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    /**
+     * Play head driven by the render loop (tempo map from the MIDI file)
+     */
+    class RenderPlayHead : public juce::AudioPlayHead
+    {
+    public:
+        RenderPlayHead(const juce::MidiMessageSequence& tempoMap, double sampleRate)
+            : tempoEvents(tempoMap), rate(sampleRate)
+        {
+        }
+
+        /**
+         * Move to the start of the next block
+         * @param startSample Position of the block in samples
+         */
+        void setPosition(juce::int64 startSample)
+        {
+            const double seconds = static_cast<double>(startSample) / rate;
+
+            // Advance the musical position with the tempo of the previous block
+            ppqPosition += (seconds - timeInSeconds) * bpm / 60.0;
+            timeInSeconds = seconds;
+            timeInSamples = startSample;
+
+            while (nextTempoEvent < tempoEvents.getNumEvents()
+                   && tempoEvents.getEventTime(nextTempoEvent) <= seconds)
+            {
+                const auto& message = tempoEvents.getEventPointer(nextTempoEvent)->message;
+                bpm = 60.0 / message.getTempoSecondsPerQuarterNote();
+                ++nextTempoEvent;
+            }
+        }
+
+        juce::Optional<PositionInfo> getPosition() const override
+        {
+            PositionInfo info;
+            info.setBpm(bpm);
+            info.setTimeInSamples(timeInSamples);
+            info.setTimeInSeconds(timeInSeconds);
+            info.setPpqPosition(ppqPosition);
+            info.setIsPlaying(true);
+            return info;
+        }
+
+    private:
+        const juce::MidiMessageSequence& tempoEvents;
+        const double rate;
+        int nextTempoEvent = 0;
+
+        double bpm = 120.0;  // Standard MIDI File default
+        double timeInSeconds = 0.0;
+        double ppqPosition = 0.0;
+        juce::int64 timeInSamples = 0;
+    };
+
+    void printUsage()
+    {
+        std::cerr << "Usage: CLEMMY3_Render --midi <file.mid> --output <file.wav>\n"
+                     "                      [--preset <file.clemmy3> | --factory <preset name>]\n"
+                     "                      [--sample-rate 48000] [--block-size 4096] [--bit-depth 24]\n"
+                     "                      [--tail 2.0] [--seed 1] [--cache-dir <dir>] [--render-threads 0]\n"
+                     "       CLEMMY3_Render --list-presets\n";
+    }
+
+    juce::String getOption(const juce::ArgumentList& args, const juce::String& option, const juce::String& fallback)
+    {
+        return args.containsOption(option) ? args.getValueForOption(option) : fallback;
+    }
+
+    bool loadPreset(CLEMMY3AudioProcessor& processor, const juce::ArgumentList& args)
+    {
+        auto& presetManager = processor.getPresetManager();
+
+        if (args.containsOption("--preset"))
+        {
+            const auto file = args.getFileForOption("--preset");
+
+            if (!presetManager.loadPresetFile(file))
+            {
+                std::cerr << "Could not load preset file " << file.getFullPathName() << "\n";
+                return false;
+            }
+        }
+        else if (args.containsOption("--factory"))
+        {
+            const auto name = args.getValueForOption("--factory");
+            const int index = presetManager.findPreset(name);
+
+            if (index < 0)
+            {
+                std::cerr << "Unknown preset \"" << name << "\" (see --list-presets)\n";
+                return false;
+            }
+
+            presetManager.loadPreset(index);
+        }
+
+        return true;
+    }
+
+    bool readMidiFile(const juce::File& file, juce::MidiMessageSequence& notes, juce::MidiMessageSequence& tempoMap)
+    {
+        juce::FileInputStream stream(file);
+        juce::MidiFile midiFile;
+
+        if (!stream.openedOk() || !midiFile.readFrom(stream))
+            return false;
+
+        midiFile.convertTimestampTicksToSeconds();
+        midiFile.findAllTempoEvents(tempoMap);
+
+        // Merge every track into one time-ordered sequence
+        for (int track = 0; track < midiFile.getNumTracks(); ++track)
+            notes.addSequence(*midiFile.getTrack(track), 0.0);
+
+        notes.updateMatchedPairs();
+        return true;
+    }
+
+    /**
+     * Render cache key: everything that affects the rendered samples
+     * (full processor state including the seed, the MIDI events, the render
+     * settings and the renderer binary itself, so a rebuild starts afresh)
+     */
+    juce::String getRenderCacheKey(CLEMMY3AudioProcessor& processor,
+                                   const juce::MidiMessageSequence& notes, const juce::MidiMessageSequence& tempoMap,
+                                   double sampleRate, int blockSize, int bitDepth, double tailSeconds)
+    {
+        juce::MemoryOutputStream key;
+
+        juce::MemoryBlock state;
+        processor.getStateInformation(state);
+        key << state;
+
+        for (const auto* sequence : { &notes, &tempoMap })
+        {
+            for (int i = 0; i < sequence->getNumEvents(); ++i)
+            {
+                const auto& message = sequence->getEventPointer(i)->message;
+
+                if (sequence == &notes && message.isMetaEvent())
+                    continue;
+
+                key.writeDouble(message.getTimeStamp());
+                key.write(message.getRawData(), static_cast<size_t>(message.getRawDataSize()));
+            }
+        }
+
+        key.writeDouble(sampleRate);
+        key.writeInt(blockSize);
+        key.writeInt(bitDepth);
+        key.writeDouble(tailSeconds);
+
+        const auto executable = juce::File::getSpecialLocation(juce::File::currentExecutableFile);
+        key.writeInt64(executable.getSize());
+        key.writeInt64(executable.getLastModificationTime().toMilliseconds());
+
+        return juce::SHA256(key.getMemoryBlock()).toHexString();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    const juce::ArgumentList args(argc, argv);
+
+    auto processor = std::make_unique<CLEMMY3AudioProcessor>();
+
+    if (args.containsOption("--list-presets"))
+    {
+        auto& presetManager = processor->getPresetManager();
+
+        for (int i = 0; i < presetManager.getNumPresets(); ++i)
+            std::cout << presetManager.getPresetName(i) << "\n";
+
+        return 0;
+    }
+
+    if (!args.containsOption("--midi") || !args.containsOption("--output"))
+    {
+        printUsage();
+        return 1;
+    }
+
+    const double sampleRate = getOption(args, "--sample-rate", "48000").getDoubleValue();
+    const int blockSize = getOption(args, "--block-size", "4096").getIntValue();
+    const int bitDepth = getOption(args, "--bit-depth", "24").getIntValue();
+    const double tailSeconds = getOption(args, "--tail", "2.0").getDoubleValue();
+    const int renderThreads = getOption(args, "--render-threads", "0").getIntValue();
+    const int numChannels = 2;
+
+    if (sampleRate <= 0.0 || blockSize <= 0 || (bitDepth != 16 && bitDepth != 24 && bitDepth != 32) || renderThreads < 0)
+    {
+        printUsage();
+        return 1;
+    }
+
+    // MIDI input
+    const auto midiFile = args.getFileForOption("--midi");
+    juce::MidiMessageSequence notes, tempoMap;
+
+    if (!readMidiFile(midiFile, notes, tempoMap))
+    {
+        std::cerr << "Could not read MIDI file " << midiFile.getFullPathName() << "\n";
+        return 1;
+    }
+
+    // Patch
+    if (!loadPreset(*processor, args))
+        return 1;
+
+    if (args.containsOption("--seed"))
+    {
+        processor->parameters.getParameter("deterministicRender")->setValueNotifyingHost(1.0f);
+        processor->setRandomSeed(static_cast<uint32_t>(getOption(args, "--seed", "1").getLargeIntValue()));
+    }
+
+    // WAV output
+    const auto outputFile = args.getFileForOption("--output");
+
+    // Render cache: reuse an identical earlier render (only seeded renders repeat)
+    juce::File cachedFile;
+
+    if (args.containsOption("--cache-dir") && !args.containsOption("--seed"))
+    {
+        std::cerr << "--cache-dir needs --seed; rendering without the cache\n";
+    }
+    else if (args.containsOption("--cache-dir"))
+    {
+        const auto cacheDirectory = args.getFileForOption("--cache-dir");
+
+        if (!cacheDirectory.createDirectory())
+        {
+            std::cerr << "Could not create cache directory " << cacheDirectory.getFullPathName() << "\n";
+            return 1;
+        }
+
+        cachedFile = cacheDirectory.getChildFile(getRenderCacheKey(*processor, notes, tempoMap, sampleRate,
+                                                                   blockSize, bitDepth, tailSeconds) + ".wav");
+
+        if (cachedFile.existsAsFile())
+        {
+            if (!cachedFile.copyFileTo(outputFile))
+            {
+                std::cerr << "Could not copy " << cachedFile.getFullPathName() << " to " << outputFile.getFullPathName() << "\n";
+                return 1;
+            }
+
+            std::cout << "Cache hit: copied " << cachedFile.getFullPathName() << " to "
+                      << outputFile.getFullPathName() << "\n";
+            return 0;
+        }
+    }
+
+    outputFile.deleteFile();
+
+    auto outputStream = std::make_unique<juce::FileOutputStream>(outputFile);
+
+    if (!outputStream->openedOk())
+    {
+        std::cerr << "Could not open " << outputFile.getFullPathName() << " for writing\n";
+        return 1;
+    }
+
+    juce::WavAudioFormat wavFormat;
+    std::unique_ptr<juce::AudioFormatWriter> writer(
+        wavFormat.createWriterFor(outputStream.get(), sampleRate, static_cast<unsigned int>(numChannels),
+                                  bitDepth, {}, 0));
+
+    if (writer == nullptr)
+    {
+        std::cerr << "Could not create WAV writer\n";
+        return 1;
+    }
+
+    outputStream.release();  // Now owned by the writer
+
+    // Processor setup
+    RenderPlayHead playHead(tempoMap, sampleRate);
+    processor->setPlayHead(&playHead);
+    processor->setNonRealtime(true);
+    processor->setNumRenderThreads(renderThreads);
+    processor->setPlayConfigDetails(0, numChannels, sampleRate, blockSize);
+    processor->prepareToPlay(sampleRate, blockSize);
+
+    // Render
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::MidiBuffer midiBuffer;
+
+    const auto totalSamples = static_cast<juce::int64>(std::ceil((notes.getEndTime() + tailSeconds) * sampleRate));
+    int nextEvent = 0;
+
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    for (juce::int64 position = 0; position < totalSamples; position += blockSize)
+    {
+        const int numSamples = static_cast<int>(juce::jmin(static_cast<juce::int64>(blockSize), totalSamples - position));
+        buffer.setSize(numChannels, numSamples, false, false, true);
+        buffer.clear();
+        midiBuffer.clear();
+
+        // Collect the events that fall inside this block at their sample offsets
+        while (nextEvent < notes.getNumEvents())
+        {
+            const auto& message = notes.getEventPointer(nextEvent)->message;
+            const auto eventSample = static_cast<juce::int64>(std::llround(message.getTimeStamp() * sampleRate));
+
+            if (eventSample >= position + numSamples)
+                break;
+
+            if (!message.isMetaEvent())
+                midiBuffer.addEvent(message, static_cast<int>(juce::jmax(static_cast<juce::int64>(0), eventSample - position)));
+
+            ++nextEvent;
+        }
+
+        playHead.setPosition(position);
+        processor->processBlock(buffer, midiBuffer);
+
+        if (!writer->writeFromAudioSampleBuffer(buffer, 0, numSamples))
+        {
+            std::cerr << "Write error\n";
+            return 1;
+        }
+    }
+
+    const double elapsedSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+    const double audioSeconds = static_cast<double>(totalSamples) / sampleRate;
+
+    processor->releaseResources();
+    processor->setPlayHead(nullptr);
+    writer.reset();
+
+    if (cachedFile != juce::File())
+    {
+        // Copy to a uniquely named temporary file and rename it over the cache
+        // entry, so concurrent jobs with the same key never share a partial file
+        juce::TemporaryFile partialFile(cachedFile);
+
+        if (!outputFile.copyFileTo(partialFile.getFile()) || !partialFile.overwriteTargetFileWithTemporary())
+            std::cerr << "Could not store the render in " << cachedFile.getFullPathName() << "\n";
+    }
+
+    std::cout << "Rendered " << audioSeconds << " s of audio in " << elapsedSeconds << " s ("
+              << (elapsedSeconds > 0.0 ? audioSeconds / elapsedSeconds : 0.0) << "x realtime) to "
+              << outputFile.getFullPathName() << "\n";
+
+    return 0;
+}